@@ -6,7 +6,30 @@
  * prioritizing higher priority items first, then by value-to-weight ratio. Divisible items
  * can be partially loaded to fill the remaining capacity.
  *
- * Key concepts: Greedy algorithm, fractional knapsack, priority-based sorting.
+ * --bench=N[,N...] (default 1M, 10M and 100M) compares the sort-then-load greedy with
+ * selectionLoad() on N random items per run. selectionLoad() buckets the items by
+ * priority in one pass, takes whole classes that fit, and inside the class that
+ * straddles the capacity finds the ratio cutoff with a weighted quickselect, repeated
+ * after each skipped indivisible item on the candidates that can still fit. That is
+ * expected O(n) when few items are skipped; if the skips keep coming, the remaining
+ * candidates are sorted instead, so the worst case is O(n log n). It reproduces the
+ * greedy's totals, including the skipping of indivisible items.
+ *
+ * --batch reads a count and that many capacities from standard input and answers them
+ * all against the item list with a CapacityIndex: the items are sorted once and prefix
+ * sums of weight and value are built, so each capacity is answered by binary searches
+ * over the prefixes (one per indivisible item it has to skip) instead of a fresh sort
+ * and loop. Queries are split across --threads=N threads. --batch-bench=N,Q does the
+ * same for Q random capacities over N random items and reports queries/sec.
+ *
+ * --incremental=N[,OPS] keeps N random items in an ItemLoader, a treap ordered like
+ * cmp whose nodes carry the weight and value of their subtree, and then applies OPS
+ * random inserts, removals and updates, each followed by a load for 40% of the current
+ * total weight. Updates and loads take O(log n) (plus O(log n) per skipped indivisible
+ * item) instead of rebuilding, re-sorting and reloading; average latencies are reported.
+ *
+ * Key concepts: Greedy algorithm, fractional knapsack, priority-based sorting,
+ * weighted selection.
  */
 
 #include <iostream>    // For input/output operations (cin, cout)
@@ -14,6 +37,12 @@
 #include <string>      // For string handling
 #include <algorithm>  // For sorting (sort)
 #include <iomanip>     // For output formatting (fixed, setprecision, setw)
+#include <chrono>      // For benchmark timing (steady_clock, duration)
+#include <cmath>       // For comparing totals (fabs)
+#include <random>      // For benchmark items and random pivots (mt19937)
+#include <map>         // For priority buckets (map)
+#include <thread>      // For answering capacity queries in parallel (thread)
+#include <limits>      // For infinite weight bounds (numeric_limits)
 
 using namespace std;  // Use the standard namespace
 
@@ -37,12 +66,754 @@ bool cmp(const Item& a, const Item& b) {
     return a.ratio > b.ratio;
 }
 
+// Totals produced by loading the boat
+struct LoadResult {
+    double totalValue = 0;     // Total utility value loaded
+    double currentWeight = 0;  // Total weight loaded
+};
+
+// Function to load the boat from items already sorted by cmp (the greedy loop)
+// Parameters:
+// - items: Items in cmp order
+// - W: Boat capacity
+// - verbose: Whether to print each loaded or skipped item
+LoadResult greedyLoad(const vector<Item>& items, double W, bool verbose) {
+    // Variables to track total value and current weight loaded
+    double totalValue = 0;
+    double currentWeight = 0;
+
+    // Iterate through sorted items to load into the boat
+    for (auto &item : items) {
+        if (currentWeight + item.weight <= W) {
+            // Take the whole item if it fits
+            currentWeight += item.weight;
+            totalValue += item.value;
+            if (verbose)
+                cout << "Loaded: " << item.name << " (Weight: " << item.weight
+                     << "kg, Value: " << item.value << ")\n";
+        } else if (item.divisible) {
+            // Take a fraction of the divisible item to fill remaining capacity
+            double remainingWeight = W - currentWeight;
+            if (remainingWeight > 0) {
+                double fraction = remainingWeight / item.weight;
+                totalValue += item.value * fraction;
+                currentWeight += remainingWeight;
+                if (verbose)
+                    cout << "Loaded: " << (fraction * 100) << "% of " << item.name
+                         << " (Weight: " << remainingWeight << "kg, Value: "
+                         << (item.value * fraction) << ")\n";
+                break;  // Boat is now full
+            }
+        } else {
+            // Skip indivisible items that don't fit
+            if (verbose)
+                cout << "Skipped: " << item.name << " (Weight: " << item.weight
+                     << "kg) - Indivisible and too heavy.\n";
+        }
+        if (currentWeight == W) break;  // Stop if boat is exactly full
+    }
+
+    LoadResult result;
+    result.totalValue = totalValue;
+    result.currentWeight = currentWeight;
+    return result;
+}
+
+// Whether item a comes before item b in the greedy order within one priority class
+// (higher ratio first; equal ratios keep their position in the item list)
+bool comesBefore(const Item* a, const Item* b) {
+    if (a->ratio != b->ratio) return a->ratio > b->ratio;
+    return a < b;
+}
+
+// Function to load the longest greedy-order prefix of v[lo..hi) that fits in remaining
+// A weighted quickselect: partition around a random pivot, take the whole front part
+// (and the pivot) if it fits, otherwise narrow down into the front part. Expected O(n).
+// Parameters:
+// - v: Items of one priority class (reordered in place)
+// - lo, hi: The range to load from
+// - remaining: Capacity left in the boat (reduced by what is loaded)
+// - result: Totals to add the loaded items to
+// - rng: Source of random pivots
+// Returns the position of the first item of the greedy order that was not loaded
+// (hi if everything fit); items in [lo, returned position) were loaded.
+size_t loadPrefix(vector<const Item*>& v, size_t lo, size_t hi, double& remaining,
+                  LoadResult& result, mt19937& rng) {
+    size_t l = lo, r = hi;
+    while (l < r) {
+        // Move a random pivot to the end and partition [l, r - 1) around it
+        swap(v[l + rng() % (r - l)], v[r - 1]);
+        const Item* pivot = v[r - 1];
+        size_t m = l;
+        double frontWeight = 0, frontValue = 0;
+        for (size_t i = l; i < r - 1; i++) {
+            if (comesBefore(v[i], pivot)) {
+                frontWeight += v[i]->weight;
+                frontValue += v[i]->value;
+                swap(v[i], v[m++]);
+            }
+        }
+        swap(v[m], v[r - 1]);  // Pivot now at m
+
+        if (frontWeight > remaining) {
+            r = m;  // The cutoff lies inside the front part
+            continue;
+        }
+
+        // The whole front part fits; the pivot is next in line
+        remaining -= frontWeight;
+        result.currentWeight += frontWeight;
+        result.totalValue += frontValue;
+        if (pivot->weight > remaining) return m;
+        remaining -= pivot->weight;
+        result.currentWeight += pivot->weight;
+        result.totalValue += pivot->value;
+        l = m + 1;
+    }
+    return r;
+}
+
+// Function to load the boat without sorting the items
+// Items are bucketed by priority in one pass. Classes that fit entirely are loaded in
+// one step. In the class that straddles the capacity, loadPrefix() finds the items
+// the greedy loop would load before its first miss; a divisible miss is loaded in
+// part and ends the loading, an indivisible miss is skipped and the selection repeats
+// on the rest of the class, after dropping indivisible items that can no longer fit.
+// Each round is expected linear in the candidates left. Usually only a few rounds are
+// needed; after log2(m) + 1 rounds the m items of the class still in play are sorted
+// and loaded in one pass instead, so the worst case is O(n log n), never O(n * misses).
+// Gives the same totals as sorting by cmp and calling greedyLoad().
+// Parameters:
+// - items: Items with their ratios computed (in any order)
+// - W: Boat capacity
+LoadResult selectionLoad(const vector<Item>& items, double W) {
+    LoadResult result;
+    mt19937 rng(12345);
+
+    // Bucket the items by priority (lowest number first) and total each class
+    map<int, vector<const Item*>> classes;
+    map<int, double> classWeight;
+    for (auto& item : items) {
+        classes[item.priority].push_back(&item);
+        classWeight[item.priority] += item.weight;
+    }
+
+    double remaining = W;
+    for (auto& entry : classes) {
+        vector<const Item*>& v = entry.second;
+
+        // Whole class fits: every item of it is loaded in any order
+        if (classWeight[entry.first] <= remaining) {
+            for (const Item* item : v) {
+                result.currentWeight += item->weight;
+                result.totalValue += item->value;
+            }
+            remaining -= classWeight[entry.first];
+            if (remaining == 0) break;  // Boat is exactly full
+            continue;
+        }
+
+        // Straddling class: repeat "drop what can no longer fit, load the fitting prefix,
+        // handle the miss", sorting the survivors only if the misses keep coming
+        size_t lo = 0, hi = v.size(), rounds = 0, roundLimit = 1;
+        for (size_t m = v.size(); m > 1; m >>= 1) roundLimit++;  // log2(class size) + 1
+        while (lo < hi && remaining > 0) {
+            if (lo > 0) {
+                // Capacity only shrinks, so indivisible items already too heavy for what
+                // is left would be skipped by the greedy loop as well
+                size_t kept = lo;
+                for (size_t i = lo; i < hi; i++) {
+                    if (v[i]->divisible || v[i]->weight <= remaining) v[kept++] = v[i];
+                }
+                hi = kept;
+            }
+            if (++rounds > roundLimit) {
+                // Many misses: one sort of the survivors bounds the work by O(m log m)
+                sort(v.begin() + lo, v.begin() + hi, comesBefore);
+                for (size_t i = lo; i < hi && remaining > 0; i++) {
+                    const Item* item = v[i];
+                    if (item->weight <= remaining) {
+                        remaining -= item->weight;
+                        result.currentWeight += item->weight;
+                        result.totalValue += item->value;
+                    } else if (item->divisible) {
+                        result.totalValue += item->value * (remaining / item->weight);
+                        result.currentWeight += remaining;
+                        remaining = 0;
+                    }
+                }
+                break;
+            }
+
+            size_t miss = loadPrefix(v, lo, hi, remaining, result, rng);
+            if (miss == hi || remaining == 0) break;
+            const Item* item = v[miss];
+            if (item->divisible) {
+                // Fill the rest of the boat with part of the item and stop
+                result.totalValue += item->value * (remaining / item->weight);
+                result.currentWeight += remaining;
+                remaining = 0;
+                break;
+            }
+            lo = miss + 1;  // Indivisible miss: skip it
+        }
+        if (remaining == 0) break;  // Boat is full
+    }
+    return result;
+}
+
+// Function to generate random items in four priority classes
+// Parameters:
+// - n: Number of items
+// - seed: Random seed
+// - totalWeight: Receives the sum of all item weights
+vector<Item> randomItems(size_t n, unsigned seed, double& totalWeight) {
+    mt19937 rng(seed);
+    uniform_real_distribution<double> weightDist(0.5, 50.0), valueDist(1.0, 1000.0);
+    vector<Item> items(n);
+    totalWeight = 0;
+    for (auto& item : items) {
+        item.weight = weightDist(rng);
+        item.value = valueDist(rng);
+        item.priority = 1 + rng() % 4;
+        item.divisible = rng() % 2;
+        item.ratio = item.value / item.weight;
+        totalWeight += item.weight;
+    }
+    return items;
+}
+
+// Most capacities reserved up front for --batch (larger counts grow as they are read)
+const size_t BATCH_RESERVE_LIMIT = 1 << 20;
+
+// Sorted item list with prefix sums, answering "what does the greedy load for W?"
+// The greedy loop loads items in cmp order until one does not fit: with prefix sums
+// that first miss is a binary search. A divisible miss ends the load with a fraction;
+// an indivisible miss is skipped and the loop carries on with the same capacity, so
+// the query jumps to the next item that could still matter (a divisible one or one
+// light enough, found by descending a segment tree of weights) and searches again.
+class CapacityIndex {
+public:
+    // Sorts the items by cmp (stable, so equal items keep list order) and builds the
+    // prefix sums and the segment tree
+    CapacityIndex(vector<Item> list) : items(move(list)) {
+        stable_sort(items.begin(), items.end(), cmp);
+        size_t n = items.size();
+        prefixWeight.assign(n + 1, 0);
+        prefixValue.assign(n + 1, 0);
+        for (size_t i = 0; i < n; i++) {
+            prefixWeight[i + 1] = prefixWeight[i] + items[i].weight;
+            prefixValue[i + 1] = prefixValue[i] + items[i].value;
+        }
+
+        // Leaf i holds the weight below which item i is worth visiting after a miss:
+        // divisible items always are (they end the load), indivisible ones if they fit
+        for (leaves = 1; leaves < n; leaves <<= 1) {}
+        blocker.assign(2 * leaves, numeric_limits<double>::infinity());
+        for (size_t i = 0; i < n; i++) {
+            blocker[leaves + i] = items[i].divisible ? -numeric_limits<double>::infinity() : items[i].weight;
+        }
+        for (size_t node = leaves - 1; node >= 1; node--) {
+            blocker[node] = min(blocker[2 * node], blocker[2 * node + 1]);
+        }
+    }
+
+    // Function to compute what greedyLoad() would load for capacity W (without sorting)
+    LoadResult query(double W) const {
+        LoadResult result;
+        size_t n = items.size(), pos = 0;
+        while (pos < n) {
+            // Items pos, pos+1, ... fit until the running weight first exceeds W
+            double limit = W - result.currentWeight;
+            size_t miss = upper_bound(prefixWeight.begin() + pos + 1, prefixWeight.end(),
+                                      prefixWeight[pos] + limit) - prefixWeight.begin() - 1;
+            result.currentWeight += prefixWeight[miss] - prefixWeight[pos];
+            result.totalValue += prefixValue[miss] - prefixValue[pos];
+            if (miss == n || result.currentWeight == W) break;
+
+            double remaining = W - result.currentWeight;
+            if (items[miss].divisible) {
+                // Fill the rest of the boat with part of the item
+                if (remaining > 0) {
+                    result.totalValue += items[miss].value * (remaining / items[miss].weight);
+                    result.currentWeight += remaining;
+                }
+                break;
+            }
+
+            // Skip the indivisible miss and every later item that cannot matter either
+            pos = firstWorthVisiting(miss + 1, remaining);
+        }
+        return result;
+    }
+
+    size_t size() const { return items.size(); }
+
+private:
+    // Function to find the first item at or after from that is divisible or weighs at
+    // most remaining (n if there is none)
+    size_t firstWorthVisiting(size_t from, double remaining) const {
+        return descend(1, 0, leaves, from, remaining);
+    }
+
+    // Function to search the segment tree node covering [lo, hi)
+    size_t descend(size_t node, size_t lo, size_t hi, size_t from, double remaining) const {
+        if (hi <= from || blocker[node] > remaining) return items.size();
+        if (hi - lo == 1) return lo;
+        size_t mid = (lo + hi) / 2;
+        size_t found = descend(2 * node, lo, mid, from, remaining);
+        return found < items.size() ? found : descend(2 * node + 1, mid, hi, from, remaining);
+    }
+
+    vector<Item> items;                       // Items in cmp order
+    vector<double> prefixWeight, prefixValue; // Sums over items[0..i)
+    size_t leaves;                            // Number of leaves in the segment tree
+    vector<double> blocker;                   // Segment tree of per-item visit thresholds
+};
+
+// Function to answer many capacity queries in parallel
+// Parameters:
+// - index: The capacity index
+// - capacities: The capacities to answer
+// - threads: Number of threads
+vector<LoadResult> answerCapacities(const CapacityIndex& index, const vector<double>& capacities, int threads) {
+    vector<LoadResult> results(capacities.size());
+    auto work = [&](size_t first, size_t last) {
+        for (size_t q = first; q < last; q++) results[q] = index.query(capacities[q]);
+    };
+    size_t q = capacities.size();
+    vector<thread> workers;
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(work, q * t / threads, q * (t + 1) / threads);
+    }
+    work(0, q / threads);
+    for (auto& w : workers) w.join();
+    return results;
+}
+
+// Whether two load results agree up to floating-point rounding
+bool sameLoad(const LoadResult& a, const LoadResult& b) {
+    return fabs(a.totalValue - b.totalValue) <= 1e-9 * max(1.0, fabs(b.totalValue)) &&
+           fabs(a.currentWeight - b.currentWeight) <= 1e-9 * max(1.0, fabs(b.currentWeight));
+}
+
+// Function to answer capacity queries with a CapacityIndex and check them against the loop
+// Parameters:
+// - items: The item list (ratios computed)
+// - capacities: The capacities to answer
+// - threads: Number of threads
+// - print: Whether to print every answer
+// - checkLimit: Maximum number of queries to check against sort + greedyLoad()
+// Returns false if any checked answer differs.
+bool runCapacityQueries(const vector<Item>& items, const vector<double>& capacities, int threads,
+                        bool print, size_t checkLimit) {
+    auto buildBegin = chrono::steady_clock::now();
+    CapacityIndex index(items);
+    auto queryBegin = chrono::steady_clock::now();
+    vector<LoadResult> results = answerCapacities(index, capacities, threads);
+    auto queryEnd = chrono::steady_clock::now();
+
+    // Reference: the original per-capacity loop over the sorted items
+    vector<Item> sorted = items;
+    stable_sort(sorted.begin(), sorted.end(), cmp);
+    size_t checked = min(checkLimit, capacities.size());
+    auto loopBegin = chrono::steady_clock::now();
+    vector<LoadResult> expected(checked);
+    for (size_t q = 0; q < checked; q++) expected[q] = greedyLoad(sorted, capacities[q], false);
+    auto loopEnd = chrono::steady_clock::now();
+
+    bool ok = true;
+    for (size_t q = 0; q < capacities.size(); q++) {
+        if (print) {
+            cout << "Capacity " << capacities[q] << " kg: weight " << results[q].currentWeight
+                 << " kg, value " << results[q].totalValue << "\n";
+        }
+        if (q < checked && !sameLoad(results[q], expected[q])) {
+            cout << "Error: capacity " << capacities[q] << " gives value " << results[q].totalValue
+                 << " but the greedy loop gives " << expected[q].totalValue << ".\n";
+            ok = false;
+        }
+    }
+
+    double buildTime = chrono::duration<double>(queryBegin - buildBegin).count();
+    double queryTime = chrono::duration<double>(queryEnd - queryBegin).count();
+    double loopTime = chrono::duration<double>(loopEnd - loopBegin).count();
+    cout << "\nIndexed " << index.size() << " items in " << buildTime << " s; answered "
+         << capacities.size() << " capacities in " << queryTime << " s ("
+         << (queryTime > 0 ? capacities.size() / queryTime : 0) << " queries/sec, " << threads << " thread(s)).\n";
+    cout << "Greedy loop per capacity: " << (loopTime > 0 ? checked / loopTime : 0) << " queries/sec over "
+         << checked << " checked capacities" << (ok ? " (all match).\n" : ".\n");
+    return ok;
+}
+
+// Long-lived item set that answers greedy loads without re-sorting after each change.
+// Items live in a treap ordered by cmp (ties by insertion order) and every node
+// stores the total weight and value of its subtree plus the smallest weight that
+// could still be loaded somewhere in it (-inf if it holds a divisible item). A load
+// takes a whole subtree when it fits, drops one when nothing in it can be loaded, and
+// only walks down the paths where the greedy stops taking items.
+class ItemLoader {
+public:
+    // Function to add an item (its ratio is computed here); returns the item's id
+    // Ids of removed items are reused, so the node array never outgrows the live set's peak.
+    size_t insert(Item item) {
+        item.ratio = item.value / item.weight;
+        Node node = {move(item), heapOrder(rng), nextSequence++, NONE, NONE, 0, 0, 0, true};
+        size_t id;
+        if (freeIds.empty()) {
+            id = nodes.size();
+            nodes.push_back(move(node));
+        } else {
+            id = freeIds.back();
+            freeIds.pop_back();
+            nodes[id] = move(node);
+        }
+        pull(id);
+        root = insertNode(root, id);
+        live++;
+        return id;
+    }
+
+    // Function to remove the item with the given id
+    // Returns false (and changes nothing) if no live item has that id.
+    bool remove(size_t id) {
+        if (!contains(id)) return false;
+        root = eraseNode(root, id);
+        nodes[id].live = false;
+        freeIds.push_back(id);
+        live--;
+        return true;
+    }
+
+    // Function to replace the item with the given id (e.g. part of it was consumed)
+    // The item keeps its place among equal items. Returns false if no live item has that id.
+    bool update(size_t id, Item item) {
+        if (!contains(id)) return false;
+        root = eraseNode(root, id);
+        item.ratio = item.value / item.weight;
+        nodes[id].item = move(item);
+        nodes[id].left = nodes[id].right = NONE;
+        pull(id);
+        root = insertNode(root, id);
+        return true;
+    }
+
+    // Function to compute what greedyLoad() would load for capacity W
+    LoadResult load(double W) const {
+        LoadResult result;
+        bool full = false;
+        loadSubtree(root, W, result, full);
+        return result;
+    }
+
+    const Item& item(size_t id) const { return nodes[id].item; }
+    bool contains(size_t id) const { return id < nodes.size() && nodes[id].live; }
+    size_t size() const { return live; }
+    double totalWeight() const { return root == NONE ? 0 : nodes[root].sumWeight; }
+
+    // Function to list the current items in insertion order (for checking against the greedy)
+    vector<Item> items() const {
+        vector<const Node*> order;
+        order.reserve(live);
+        for (const auto& node : nodes)
+            if (node.live) order.push_back(&node);
+        sort(order.begin(), order.end(), [](const Node* a, const Node* b) { return a->sequence < b->sequence; });
+        vector<Item> list;
+        list.reserve(order.size());
+        for (const Node* node : order) list.push_back(node->item);
+        return list;
+    }
+
+private:
+    static constexpr size_t NONE = numeric_limits<size_t>::max();
+
+    struct Node {
+        Item item;
+        unsigned heapKey;              // Random treap priority (max-heap)
+        size_t sequence;               // Insertion number (breaks ties between equal items)
+        size_t left, right;            // Children (NONE if absent)
+        double sumWeight, sumValue;    // Totals over the subtree
+        double minBlocker;             // Smallest loadable weight in the subtree
+        bool live;                     // False once removed
+    };
+
+    // Whether node a comes before node b in loading order
+    bool before(size_t a, size_t b) const {
+        const Item& x = nodes[a].item;
+        const Item& y = nodes[b].item;
+        if (x.priority != y.priority) return x.priority < y.priority;
+        if (x.ratio != y.ratio) return x.ratio > y.ratio;
+        return nodes[a].sequence < nodes[b].sequence;
+    }
+
+    // Function to recompute a node's aggregates from its children
+    void pull(size_t t) {
+        Node& node = nodes[t];
+        node.sumWeight = node.item.weight;
+        node.sumValue = node.item.value;
+        node.minBlocker = node.item.divisible ? -numeric_limits<double>::infinity() : node.item.weight;
+        for (size_t child : {node.left, node.right}) {
+            if (child == NONE) continue;
+            node.sumWeight += nodes[child].sumWeight;
+            node.sumValue += nodes[child].sumValue;
+            node.minBlocker = min(node.minBlocker, nodes[child].minBlocker);
+        }
+    }
+
+    // Function to split subtree t into the nodes before id (left) and the rest (right)
+    void split(size_t t, size_t id, size_t& left, size_t& right) {
+        if (t == NONE) {
+            left = right = NONE;
+        } else if (before(t, id)) {
+            split(nodes[t].right, id, nodes[t].right, right);
+            left = t;
+            pull(t);
+        } else {
+            split(nodes[t].left, id, left, nodes[t].left);
+            right = t;
+            pull(t);
+        }
+    }
+
+    // Function to join two subtrees where every node of a comes before every node of b
+    size_t merge(size_t a, size_t b) {
+        if (a == NONE) return b;
+        if (b == NONE) return a;
+        if (nodes[a].heapKey > nodes[b].heapKey) {
+            nodes[a].right = merge(nodes[a].right, b);
+            pull(a);
+            return a;
+        }
+        nodes[b].left = merge(a, nodes[b].left);
+        pull(b);
+        return b;
+    }
+
+    size_t insertNode(size_t t, size_t id) {
+        if (t == NONE) return id;
+        if (nodes[id].heapKey > nodes[t].heapKey) {
+            split(t, id, nodes[id].left, nodes[id].right);
+            pull(id);
+            return id;
+        }
+        if (before(id, t)) nodes[t].left = insertNode(nodes[t].left, id);
+        else nodes[t].right = insertNode(nodes[t].right, id);
+        pull(t);
+        return t;
+    }
+
+    size_t eraseNode(size_t t, size_t id) {
+        if (t == id) return merge(nodes[t].left, nodes[t].right);
+        if (before(id, t)) nodes[t].left = eraseNode(nodes[t].left, id);
+        else nodes[t].right = eraseNode(nodes[t].right, id);
+        pull(t);
+        return t;
+    }
+
+    // Function to run the greedy over subtree t, continuing from result
+    void loadSubtree(size_t t, double W, LoadResult& result, bool& full) const {
+        if (t == NONE || full) return;
+        const Node& node = nodes[t];
+        if (result.currentWeight + node.sumWeight <= W) {
+            // The whole subtree fits
+            result.currentWeight += node.sumWeight;
+            result.totalValue += node.sumValue;
+            full = result.currentWeight == W;
+            return;
+        }
+        if (node.minBlocker > W - result.currentWeight) return;  // Nothing here can be loaded
+
+        loadSubtree(node.left, W, result, full);
+        if (full) return;
+        if (result.currentWeight + node.item.weight <= W) {
+            result.currentWeight += node.item.weight;
+            result.totalValue += node.item.value;
+        } else if (node.item.divisible) {
+            // Fill the rest of the boat with part of the item
+            double remainingWeight = W - result.currentWeight;
+            result.totalValue += node.item.value * (remainingWeight / node.item.weight);
+            result.currentWeight += remainingWeight;
+            // The boat is full now, as in greedyLoad() (rounding may leave the weights unequal)
+            full = true;
+            return;
+        }
+        full = result.currentWeight == W;
+        loadSubtree(node.right, W, result, full);
+    }
+
+    vector<Node> nodes;        // Items indexed by id (dead slots are listed in freeIds)
+    vector<size_t> freeIds;    // Ids of removed items, reused by insert()
+    size_t root = NONE;        // Root of the treap
+    size_t live = 0;           // Number of items not removed
+    size_t nextSequence = 0;   // Insertion number of the next item
+    mt19937 rng{12345};
+    uniform_int_distribution<unsigned> heapOrder;
+};
+
+// Function to measure ItemLoader update and load latency on random items
+// Parameters:
+// - n: Number of items initially in the set
+// - ops: Number of random changes, each followed by a load
+// Returns false if a load differs from sorting plus greedyLoad().
+bool benchmarkIncremental(size_t n, size_t ops) {
+    double totalWeight;
+    vector<Item> initial = randomItems(n, 3, totalWeight);
+    ItemLoader loader;
+    vector<size_t> ids;
+    auto buildBegin = chrono::steady_clock::now();
+    for (auto& item : initial) ids.push_back(loader.insert(move(item)));
+    auto buildEnd = chrono::steady_clock::now();
+
+    // Greedy loop on the sorted current items, for checking
+    auto reference = [&](double W) {
+        vector<Item> sorted = loader.items();
+        stable_sort(sorted.begin(), sorted.end(), cmp);
+        return greedyLoad(sorted, W, false);
+    };
+
+    mt19937 rng(4);
+    double fresh;
+    vector<Item> arrivals = randomItems(ops, 5, fresh);
+    uniform_real_distribution<double> consumed(0.1, 0.9);
+    double updateTime = 0, loadTime = 0;
+    bool ok = true;
+    for (size_t op = 0; op < ops; op++) {
+        auto begin = chrono::steady_clock::now();
+        unsigned kind = ids.empty() ? 0 : rng() % 3;
+        if (kind == 0) {
+            // New supplies arrive
+            ids.push_back(loader.insert(arrivals[op]));
+        } else {
+            size_t slot = rng() % ids.size();
+            if (kind == 1) {
+                // An item is used up
+                loader.remove(ids[slot]);
+                ids[slot] = ids.back();
+                ids.pop_back();
+            } else {
+                // Part of an item is used up
+                Item item = loader.item(ids[slot]);
+                double keep = consumed(rng);
+                item.weight *= keep;
+                item.value *= keep;
+                loader.update(ids[slot], item);
+            }
+        }
+        auto middle = chrono::steady_clock::now();
+        double W = loader.totalWeight() * 0.4;
+        LoadResult result = loader.load(W);
+        auto end = chrono::steady_clock::now();
+        updateTime += chrono::duration<double>(middle - begin).count();
+        loadTime += chrono::duration<double>(end - middle).count();
+
+        // Check a few loads against the full sort-and-load
+        if ((op + 1) % max<size_t>(1, ops / 4) == 0 && !sameLoad(result, reference(W))) {
+            cout << "Error: load after change " << op + 1 << " differs from the greedy loop.\n";
+            ok = false;
+        }
+    }
+
+    cout << "Items: " << n << " (" << loader.size() << " after " << ops << " changes)\n";
+    cout << "  Build by insertion: " << chrono::duration<double>(buildEnd - buildBegin).count() << " s\n";
+    cout << "  Average change: " << (ops ? updateTime / ops * 1e6 : 0) << " us\n";
+    cout << "  Average load:   " << (ops ? loadTime / ops * 1e6 : 0) << " us\n";
+    auto sortBegin = chrono::steady_clock::now();
+    reference(loader.totalWeight() * 0.4);
+    auto sortEnd = chrono::steady_clock::now();
+    cout << "  Sort + greedy from scratch: " << chrono::duration<double>(sortEnd - sortBegin).count() * 1e6
+         << " us" << (ok ? " (checked loads match)\n" : "\n");
+    return ok;
+}
+
+// Function to compare sorting plus greedyLoad() with selectionLoad() on random items
+// Parameters:
+// - n: Number of items
+void benchmarkLoaders(size_t n) {
+    // Random items in four priority classes; capacity is 40% of the total weight
+    double totalWeight;
+    vector<Item> items = randomItems(n, n, totalWeight);
+    double W = totalWeight * 0.4;
+
+    auto selectBegin = chrono::steady_clock::now();
+    LoadResult fast = selectionLoad(items, W);
+    auto selectEnd = chrono::steady_clock::now();
+
+    // stable_sort keeps equal ratios in list order, the tie rule selectionLoad() uses
+    auto sortBegin = chrono::steady_clock::now();
+    stable_sort(items.begin(), items.end(), cmp);
+    LoadResult greedy = greedyLoad(items, W, false);
+    auto sortEnd = chrono::steady_clock::now();
+
+    double sortTime = chrono::duration<double>(sortEnd - sortBegin).count();
+    double selectTime = chrono::duration<double>(selectEnd - selectBegin).count();
+    bool same = sameLoad(fast, greedy);
+
+    cout << setw(12) << n << " items: sort + greedy " << setw(8) << sortTime << " s, selection "
+         << setw(8) << selectTime << " s (" << (selectTime > 0 ? sortTime / selectTime : 0) << "x), value "
+         << greedy.totalValue << " vs " << fast.totalValue << (same ? " [match]" : " [MISMATCH]") << "\n";
+}
+
+// Function to parse a comma-separated list of counts (e.g. "1000000,50000")
+vector<size_t> parseCounts(const string& text) {
+    vector<size_t> counts;
+    for (size_t pos = 0; pos < text.size();) {
+        size_t comma = text.find(',', pos);
+        if (comma == string::npos) comma = text.size();
+        counts.push_back(stoull(text.substr(pos, comma - pos)));
+        pos = comma + 1;
+    }
+    return counts;
+}
+
 // Main function: Entry point of the program
-int main() {
-    // Variable for boat capacity
-    double W;
-    cout << "Enter maximum boat capacity (kg): ";
-    cin >> W;
+int main(int argc, char* argv[]) {
+    // Command-line modes (the interactive single-capacity run is the default)
+    vector<size_t> benchSizes, batchBench, incremental;
+    bool batch = false;
+    int threads = 1;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--bench") {
+            benchSizes = {1000000, 10000000, 100000000};
+        } else if (arg.rfind("--bench=", 0) == 0) {
+            benchSizes = parseCounts(arg.substr(8));
+        } else if (arg == "--batch") {
+            batch = true;
+        } else if (arg.rfind("--batch-bench=", 0) == 0) {
+            batchBench = parseCounts(arg.substr(14));
+        } else if (arg.rfind("--incremental=", 0) == 0) {
+            incremental = parseCounts(arg.substr(14));
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            threads = stoi(arg.substr(10));
+            if (threads <= 0) threads = thread::hardware_concurrency();
+        } else {
+            cout << "Usage: " << argv[0] << " [--bench[=N,N...] | --batch | --batch-bench=N,Q | --incremental=N[,OPS]] [--threads=N]" << endl;
+            return 1;
+        }
+    }
+
+    if (!benchSizes.empty()) {
+        cout << fixed << setprecision(3);
+        for (size_t n : benchSizes) benchmarkLoaders(n);
+        return 0;
+    }
+
+    if (!incremental.empty()) {
+        cout << fixed << setprecision(3);
+        return benchmarkIncremental(incremental[0], incremental.size() > 1 ? incremental[1] : 100000) ? 0 : 1;
+    }
+
+    if (batchBench.size() == 2) {
+        // Q random capacities between 0 and the total weight of N random items
+        double totalWeight;
+        vector<Item> items = randomItems(batchBench[0], 1, totalWeight);
+        mt19937 rng(2);
+        uniform_real_distribution<double> capacityDist(0, totalWeight);
+        vector<double> capacities(batchBench[1]);
+        for (auto& W : capacities) W = capacityDist(rng);
+        cout << fixed << setprecision(2);
+        return runCapacityQueries(items, capacities, threads, false, 1000) ? 0 : 1;
+    }
 
     // Initialize a vector of items with predefined data
     vector<Item> items = {
@@ -57,6 +828,31 @@ int main() {
     for (auto &item : items)
         item.ratio = item.value / item.weight;
 
+    if (batch) {
+        // Read the number of capacities, then the capacities themselves
+        size_t count;
+        if (!(cin >> count)) {
+            cout << "Error: Expected the number of capacities." << endl;
+            return 1;
+        }
+        // Grow with the input rather than trusting the count up front
+        vector<double> capacities;
+        capacities.reserve(min(count, BATCH_RESERVE_LIMIT));
+        double W;
+        while (capacities.size() < count && cin >> W) capacities.push_back(W);
+        if (capacities.size() < count) {
+            cout << "Error: Expected " << count << " capacities but read " << capacities.size() << "." << endl;
+            return 1;
+        }
+        cout << fixed << setprecision(2);
+        return runCapacityQueries(items, capacities, threads, true, capacities.size()) ? 0 : 1;
+    }
+
+    // Variable for boat capacity
+    double W;
+    cout << "Enter maximum boat capacity (kg): ";
+    cin >> W;
+
     // Sort the items using the custom comparison function
     sort(items.begin(), items.end(), cmp);
 
@@ -80,44 +876,15 @@ int main() {
              << setw(10) << (item.divisible ? "Divisible" : "Indivisible") << endl;
     }
 
-    // Variables to track total value and current weight loaded
-    double totalValue = 0;
-    double currentWeight = 0;
-
     cout << "\n--- Loading the Boat ---\n";
 
-    // Iterate through sorted items to load into the boat
-    for (auto &item : items) {
-        if (currentWeight + item.weight <= W) {
-            // Take the whole item if it fits
-            currentWeight += item.weight;
-            totalValue += item.value;
-            cout << "Loaded: " << item.name << " (Weight: " << item.weight
-                 << "kg, Value: " << item.value << ")\n";
-        } else if (item.divisible) {
-            // Take a fraction of the divisible item to fill remaining capacity
-            double remainingWeight = W - currentWeight;
-            if (remainingWeight > 0) {
-                double fraction = remainingWeight / item.weight;
-                totalValue += item.value * fraction;
-                currentWeight += remainingWeight;
-                cout << "Loaded: " << (fraction * 100) << "% of " << item.name
-                     << " (Weight: " << remainingWeight << "kg, Value: "
-                     << (item.value * fraction) << ")\n";
-                break;  // Boat is now full
-            }
-        } else {
-            // Skip indivisible items that don't fit
-            cout << "Skipped: " << item.name << " (Weight: " << item.weight
-                 << "kg) - Indivisible and too heavy.\n";
-        }
-        if (currentWeight == W) break;  // Stop if boat is exactly full
-    }
+    // Load the sorted items into the boat
+    LoadResult load = greedyLoad(items, W, true);
 
     // Display the final report
     cout << "\n--- Final Report ---\n";
-    cout << "Total weight in boat: " << currentWeight << " kg\n";
-    cout << "Total utility value: " << totalValue << "\n";
+    cout << "Total weight in boat: " << load.currentWeight << " kg\n";
+    cout << "Total utility value: " << load.totalValue << "\n";
 
     return 0;  // Successful execution
 }
@@ -6,8 +6,37 @@
  * auxiliary space used during the sorting process. The program also measures the time taken
  * for sorting and displays the first 5 sorted orders.
  *
+ * Passing --threads=N additionally runs a parallel merge sort on the same input with
+ * 1, 2, 4, ... N threads and reports the speedup of each run over the serial sort.
+ * --cutoff=N sets the subarray size below which the parallel sort falls back to the
+ * serial merge_sort().
+ *
+ * --algo=pingpong selects a merge sort that allocates a single auxiliary buffer up front
+ * and alternates source and destination between recursion levels, instead of building
+ * new L/R vectors in every merge() call. The report counts heap allocations made while
+ * sorting so the two variants can be compared.
+ *
+ * --algo=radix selects an LSD radix sort on the timestamp offset from the earliest
+ * order. A key-range scan skips digits that are the same for every order, so the
+ * ~100k-minute window produced by generate_sample_orders() needs only three passes.
+ * Any algorithm other than merge is checked against merge_sort() on the same input
+ * and both throughputs are printed in records/sec.
+ *
+ * Order files hold a fixed 32-byte header (magic, version, record count and earliest
+ * timestamp) followed by 16-byte Order records (32-bit id, 4 zero bytes, 64-bit
+ * timestamp, in native byte order). --generate=FILE writes the generated
+ * orders to such a file instead of sorting them.
+ *
+ * --external=FILE sorts an order file that may be larger than memory: chunks that fit
+ * in --mem-limit are sorted into runs, and the runs are merged k ways with a loser
+ * tree using large, double-buffered sequential reads and writes. The result goes to
+ * --output (FILE.sorted by default).
+ *
+ * --mmap=FILE maps an order file that fits in memory and sorts its records in place,
+ * so the sorted result is written back through the mapping without a vector copy.
+ *
  * Key concepts: Merge sort, time complexity (O(n log n)), space complexity analysis,
- * timestamp handling in C++.
+ * timestamp handling in C++, task-parallel divide and conquer.
  */
 
 #include <iostream>  // For input/output operations (cin, cout)
@@ -15,41 +44,122 @@
 #include <ctime>     // For time-related functions (time_t, mktime, gmtime, strftime)
 #include <cstdlib>   // For random number generation (rand, srand)
 #include <iomanip>   // For output formatting (fixed, setprecision, setw)
+#include <algorithm> // For binary search and copying (lower_bound, upper_bound, copy)
+#include <atomic>    // For thread-safe space tracking (atomic)
+#include <chrono>    // For wall-clock timing (steady_clock, duration)
+#include <string>    // For command-line argument handling (string, stoi)
+#include <thread>    // For the parallel sort (thread, hardware_concurrency)
+#include <new>       // For replacing the global allocator (operator new, bad_alloc)
+#include <cstdint>   // For fixed-width radix keys (uint64_t)
+#include <cstdio>    // For binary file I/O (FILE, fread, fwrite, fseeko, rename, remove)
+#include <mutex>     // For handing blocks to the I/O threads (mutex, lock_guard)
+#include <condition_variable>  // For waking the I/O threads (condition_variable)
+#include <functional>  // For block transfer jobs (function)
+#include <memory>    // For owning run readers (unique_ptr)
+#include <cctype>    // For parsing size suffixes (toupper)
+#include <cstring>   // For comparing the file magic (memcmp, memcpy)
+#include <cstddef>   // For checking the record layout (offsetof)
+#include <fcntl.h>   // For opening mapped files (open)
+#include <unistd.h>  // For closing mapped files (close)
+#include <sys/mman.h>      // For memory-mapped order files (mmap, msync, munmap)
+#include <sys/stat.h>      // For the size of mapped files (fstat)
+#include <sys/resource.h>  // For the peak resident set size (getrusage)
 
 using namespace std;  // Use the standard namespace to avoid prefixing std::
 
 // Global variable to track the maximum auxiliary space used during merge operations
-size_t max_auxiliary_space = 0;
+// (atomic because the parallel sort calls merge() from several threads at once)
+atomic<size_t> max_auxiliary_space(0);
+
+// Subarray size below which the parallel sort stops splitting and uses merge_sort()
+int parallel_cutoff = 1 << 14;
+
+// Run length at or below which the ping-pong sort switches to insertion sort
+const int INSERTION_SORT_CUTOFF = 32;
+
+// Radix sort digit width in bits and the resulting number of buckets per digit
+const int RADIX_BITS = 8;
+const int RADIX_BUCKETS = 1 << RADIX_BITS;
+
+// Number of interleaved histogram copies filled by the counting pass
+const int HISTOGRAM_COPIES = 4;
+
+// Bounds on the size of one read or write buffer in the external merge
+const size_t MIN_IO_BLOCK = 256 * 1024;
+const size_t MAX_IO_BLOCK = 8 * 1024 * 1024;
+
+// Global counters of file traffic in the external sort (updated by background I/O)
+atomic<unsigned long long> bytes_read(0);
+atomic<unsigned long long> bytes_written(0);
+
+// Global counter of heap allocations, incremented by the operator new below
+atomic<size_t> heap_allocations(0);
+
+// Replacement global allocator that counts every heap allocation in the program
+void* operator new(size_t size) {
+    heap_allocations++;
+    if (void* p = malloc(size)) return p;
+    throw bad_alloc();
+}
+
+// Matching deallocation functions for the counting allocator
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
 
 // Structure to represent an order with an ID and a timestamp
 struct Order {
-    int order_id;      // Unique identifier for the order
-    time_t timestamp;  // Timestamp when the order was placed (Unix timestamp)
+    int order_id;          // Unique identifier for the order
+    int32_t padding = 0;   // Always 0, so order files never hold stray bytes
+    time_t timestamp;      // Timestamp when the order was placed (Unix timestamp)
 };
 
+// Order files hold Order records exactly as they are laid out in memory (--mmap sorts
+// them in place), so the layout is pinned here
+static_assert(sizeof(time_t) == 8 && sizeof(Order) == 16 && offsetof(Order, timestamp) == 8,
+              "order files need 16-byte records with a 64-bit timestamp at offset 8");
+
+// Header at the start of every order file, followed by count Order records
+struct OrderFileHeader {
+    char magic[4];      // Always "ORDF"
+    uint32_t version;   // Format version (ORDER_FILE_VERSION)
+    uint64_t count;     // Number of records after the header
+    int64_t base_time;  // Earliest timestamp in the file (0 if empty)
+    uint64_t reserved;  // Keeps the records 16-byte aligned
+};
+
+// Current order file format version
+const uint32_t ORDER_FILE_VERSION = 1;
+
+// Function to record an auxiliary allocation, keeping the largest one seen so far
+// Parameters:
+// - bytes: Size of the auxiliary allocation in bytes
+void record_auxiliary_space(size_t bytes) {
+    size_t seen = max_auxiliary_space.load();
+    // Retry until we either store the larger value or another thread stored a larger one
+    while (bytes > seen && !max_auxiliary_space.compare_exchange_weak(seen, bytes)) {
+    }
+}
+
 // Function to merge two sorted subarrays of orders into a single sorted array
 // Parameters:
-// - orders: The vector of orders to be sorted
+// - orders: The array of orders to be sorted
 // - left: Starting index of the left subarray
 // - mid: Ending index of the left subarray (mid + 1 is start of right)
 // - right: Ending index of the right subarray
-void merge(vector<Order>& orders, int left, int mid, int right) {
+void merge(Order* orders, ptrdiff_t left, ptrdiff_t mid, ptrdiff_t right) {
     // Calculate sizes of the two subarrays
-    int n1 = mid - left + 1;  // Size of left subarray
-    int n2 = right - mid;     // Size of right subarray
+    ptrdiff_t n1 = mid - left + 1;  // Size of left subarray
+    ptrdiff_t n2 = right - mid;     // Size of right subarray
 
     // Create temporary vectors for the left and right subarrays
-    vector<Order> L(orders.begin() + left, orders.begin() + mid + 1);
-    vector<Order> R(orders.begin() + mid + 1, orders.begin() + right + 1);
+    vector<Order> L(orders + left, orders + mid + 1);
+    vector<Order> R(orders + mid + 1, orders + right + 1);
 
     // Track auxiliary space usage: space for L and R vectors
-    size_t current_aux_space = (L.size() + R.size()) * sizeof(Order);
-    if (current_aux_space > max_auxiliary_space) {
-        max_auxiliary_space = current_aux_space;  // Update max auxiliary space if larger
-    }
+    record_auxiliary_space((L.size() + R.size()) * sizeof(Order));
 
     // Merge the two subarrays back into the original array
-    int i = 0, j = 0, k = left;  // i: index for L, j: index for R, k: index for orders
+    ptrdiff_t i = 0, j = 0, k = left;  // i: index for L, j: index for R, k: index for orders
     while (i < n1 && j < n2) {
         // Compare timestamps and place the smaller one into orders
         if (L[i].timestamp <= R[j].timestamp) {
@@ -70,14 +180,14 @@ void merge(vector<Order>& orders, int left, int mid, int right) {
 
 // Recursive function to perform merge sort on the orders array
 // Parameters:
-// - orders: The vector of orders to be sorted
+// - orders: The array of orders to be sorted
 // - left: Starting index of the subarray to sort
 // - right: Ending index of the subarray to sort
-void merge_sort(vector<Order>& orders, int left, int right) {
+void merge_sort(Order* orders, ptrdiff_t left, ptrdiff_t right) {
     // Base case: if the subarray has one or zero elements, it's already sorted
     if (left < right) {
         // Calculate the middle index to divide the array into two halves
-        int mid = left + (right - left) / 2;
+        ptrdiff_t mid = left + (right - left) / 2;
 
         // Recursively sort the left half
         merge_sort(orders, left, mid);
@@ -90,6 +200,288 @@ void merge_sort(vector<Order>& orders, int left, int right) {
     }
 }
 
+// Function to merge two sorted runs into an output array (serial, stable)
+// Parameters:
+// - a, na: The first sorted run and its length
+// - b, nb: The second sorted run and its length
+// - out: Destination with room for na + nb orders (must not overlap a or b)
+void merge_runs(const Order* a, ptrdiff_t na, const Order* b, ptrdiff_t nb, Order* out) {
+    ptrdiff_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        // Ties go to the first run, exactly like merge()
+        if (a[i].timestamp <= b[j].timestamp) {
+            out[k++] = a[i++];
+        } else {
+            out[k++] = b[j++];
+        }
+    }
+    while (i < na) out[k++] = a[i++];
+    while (j < nb) out[k++] = b[j++];
+}
+
+// Function to merge two sorted runs using several threads
+// The larger run is cut at its middle element and the matching split point in the other
+// run is found by binary search, giving two independent merges that write disjoint
+// parts of the output. Equal timestamps from the first run always land before those
+// from the second run, so the result is identical to merge_runs().
+// Parameters:
+// - a, na: The first sorted run and its length
+// - b, nb: The second sorted run and its length
+// - out: Destination with room for na + nb orders
+// - threads: Number of threads this merge may use
+void parallel_merge(const Order* a, ptrdiff_t na, const Order* b, ptrdiff_t nb, Order* out, int threads) {
+    // Small merges are not worth a thread
+    if (threads <= 1 || na + nb <= parallel_cutoff) {
+        merge_runs(a, na, b, nb, out);
+        return;
+    }
+
+    ptrdiff_t ma, mb;  // Split points in a and b
+    if (na >= nb) {
+        // Everything in b strictly before a[ma] goes to the left half
+        ma = na / 2;
+        mb = lower_bound(b, b + nb, a[ma].timestamp,
+            [](const Order& o, time_t t) { return o.timestamp < t; }) - b;
+    } else {
+        // Everything in a up to and including b[mb]'s timestamp goes to the left half
+        mb = nb / 2;
+        ma = upper_bound(a, a + na, b[mb].timestamp,
+            [](time_t t, const Order& o) { return t < o.timestamp; }) - a;
+    }
+
+    // Merge the left halves on a new thread and the right halves on this one
+    thread helper(parallel_merge, a, ma, b, mb, out, threads / 2);
+    parallel_merge(a + ma, na - ma, b + mb, nb - mb, out + ma + mb, threads - threads / 2);
+    helper.join();
+}
+
+// Function to copy a block of orders using several threads
+// Parameters:
+// - src: Source orders
+// - n: Number of orders to copy
+// - dst: Destination (must not overlap src)
+// - threads: Number of threads to use
+void parallel_copy(const Order* src, ptrdiff_t n, Order* dst, int threads) {
+    vector<thread> workers;
+    ptrdiff_t chunk = (n + threads - 1) / threads;
+    // Hand every chunk but the first to a helper thread
+    for (int t = 1; t < threads && t * chunk < n; t++) {
+        ptrdiff_t begin = t * chunk;
+        ptrdiff_t count = min(chunk, n - begin);
+        workers.emplace_back([=]() { copy(src + begin, src + begin + count, dst + begin); });
+    }
+    copy(src, src + min(chunk, n), dst);
+    for (auto& w : workers) w.join();
+}
+
+// Recursive parallel merge sort on orders[left..right]
+// The thread budget is split between the two halves near the top of the recursion;
+// once a subarray is below parallel_cutoff or only one thread is left, it is handed
+// to the serial merge_sort().
+// Parameters:
+// - orders: The vector of orders to be sorted
+// - aux: Scratch buffer of the same size as orders
+// - left: Starting index of the subarray to sort
+// - right: Ending index of the subarray to sort
+// - threads: Number of threads this subarray may use
+void parallel_merge_sort_range(vector<Order>& orders, vector<Order>& aux, ptrdiff_t left, ptrdiff_t right,
+                               int threads) {
+    if (threads <= 1 || right - left + 1 <= parallel_cutoff) {
+        merge_sort(orders.data(), left, right);
+        return;
+    }
+
+    ptrdiff_t mid = left + (right - left) / 2;
+
+    // Sort the left half on a new thread while this thread sorts the right half
+    thread helper(parallel_merge_sort_range, ref(orders), ref(aux), left, mid, threads / 2);
+    parallel_merge_sort_range(orders, aux, mid + 1, right, threads - threads / 2);
+    helper.join();
+
+    // Merge both halves into aux with all threads, then copy the result back
+    ptrdiff_t n = right - left + 1;
+    parallel_merge(&orders[left], mid - left + 1, &orders[mid + 1], right - mid, &aux[left], threads);
+    parallel_copy(&aux[left], n, &orders[left], threads);
+}
+
+// Function to sort all orders with the parallel merge sort
+// Parameters:
+// - orders: The vector of orders to be sorted
+// - threads: Number of threads to use
+void parallel_merge_sort(vector<Order>& orders, int threads) {
+    if (orders.empty()) return;
+
+    // One scratch buffer shared by all merges
+    vector<Order> aux(orders.size());
+    record_auxiliary_space(aux.size() * sizeof(Order));
+
+    parallel_merge_sort_range(orders, aux, 0, static_cast<ptrdiff_t>(orders.size()) - 1, threads);
+}
+
+// Function to check that two order vectors hold the same orders in the same order
+// Parameters:
+// - a, b: The vectors to compare
+bool same_orders(const vector<Order>& a, const vector<Order>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].order_id != b[i].order_id || a[i].timestamp != b[i].timestamp) return false;
+    }
+    return true;
+}
+
+// Function to insertion sort a small subarray in place (stable)
+// Parameters:
+// - a: The orders to sort
+// - left: Starting index of the subarray
+// - right: Ending index of the subarray
+void insertion_sort(Order* a, ptrdiff_t left, ptrdiff_t right) {
+    for (ptrdiff_t i = left + 1; i <= right; i++) {
+        Order key = a[i];
+        ptrdiff_t j = i - 1;
+        // Shift only strictly later timestamps so equal ones keep their order
+        while (j >= left && a[j].timestamp > key.timestamp) {
+            a[j + 1] = a[j];
+            j--;
+        }
+        a[j + 1] = key;
+    }
+}
+
+// Recursive ping-pong merge sort on [left..right]
+// On entry src and dst hold the same orders in this range; on return dst holds them
+// sorted. The halves are sorted into src (with the roles of the buffers swapped) and
+// then merged back into dst, so no level of the recursion needs a buffer of its own.
+// Parameters:
+// - src: Buffer used as scratch space by this level
+// - dst: Buffer that receives the sorted range
+// - left: Starting index of the range
+// - right: Ending index of the range
+void pingpong_sort_range(Order* src, Order* dst, ptrdiff_t left, ptrdiff_t right) {
+    // Small runs: insertion sort directly in the destination
+    if (right - left + 1 <= INSERTION_SORT_CUTOFF) {
+        insertion_sort(dst, left, right);
+        return;
+    }
+
+    ptrdiff_t mid = left + (right - left) / 2;
+
+    // Sort both halves into src, using dst as their scratch space
+    pingpong_sort_range(dst, src, left, mid);
+    pingpong_sort_range(dst, src, mid + 1, right);
+
+    // Halves already in order: a straight copy replaces the merge
+    if (src[mid].timestamp <= src[mid + 1].timestamp) {
+        copy(src + left, src + right + 1, dst + left);
+        return;
+    }
+
+    merge_runs(src + left, mid - left + 1, src + mid + 1, right - mid, dst + left);
+}
+
+// Function to sort all orders with the ping-pong merge sort
+// The only heap allocation is the auxiliary copy of the input.
+// Parameters:
+// - orders: The array of orders to be sorted
+// - n: Number of orders
+void pingpong_merge_sort(Order* orders, size_t n) {
+    if (n == 0) return;
+
+    // One auxiliary buffer of n orders, starting as a copy of the input
+    vector<Order> aux(orders, orders + n);
+    record_auxiliary_space(aux.size() * sizeof(Order));
+
+    pingpong_sort_range(aux.data(), orders, 0, static_cast<ptrdiff_t>(n) - 1);
+}
+
+// Function to sort all orders with an LSD radix sort on the timestamp
+// The key of an order is its offset from the earliest timestamp, so only the digits
+// spanned by the key range are ever visited. All digit histograms are built in a
+// single counting pass; consecutive orders go to different histogram copies so the
+// increments do not wait on each other. Each pass then scatters stably between
+// orders and one shared auxiliary buffer.
+// Parameters:
+// - orders: The array of orders to be sorted
+// - n: Number of orders
+void radix_sort(Order* orders, size_t n) {
+    if (n <= 1) return;
+
+    // Key-range scan: find the base timestamp and the largest key
+    time_t min_ts = orders[0].timestamp, max_ts = orders[0].timestamp;
+    for (size_t i = 1; i < n; i++) {
+        min_ts = min(min_ts, orders[i].timestamp);
+        max_ts = max(max_ts, orders[i].timestamp);
+    }
+    uint64_t key_range = static_cast<uint64_t>(max_ts) - static_cast<uint64_t>(min_ts);
+
+    // Digits above the highest set bit of the key range are zero for every order
+    int digits = 0;
+    while (digits * RADIX_BITS < 64 && (key_range >> (digits * RADIX_BITS)) != 0) digits++;
+    if (digits == 0) return;  // All timestamps equal: already in stable order
+
+    // Counting pass: hist[(d * HISTOGRAM_COPIES + c) * RADIX_BUCKETS + b]
+    vector<size_t> hist(digits * HISTOGRAM_COPIES * RADIX_BUCKETS, 0);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t key = static_cast<uint64_t>(orders[i].timestamp) - static_cast<uint64_t>(min_ts);
+        size_t* copy_hist = &hist[(i % HISTOGRAM_COPIES) * RADIX_BUCKETS];
+        for (int d = 0; d < digits; d++) {
+            copy_hist[d * HISTOGRAM_COPIES * RADIX_BUCKETS + ((key >> (d * RADIX_BITS)) & (RADIX_BUCKETS - 1))]++;
+        }
+    }
+
+    // One auxiliary buffer shared by all scatter passes
+    vector<Order> aux(n);
+    record_auxiliary_space(aux.size() * sizeof(Order));
+    Order* src = orders;
+    Order* dst = aux.data();
+
+    for (int d = 0; d < digits; d++) {
+        // Fold the histogram copies into the starting offset of each bucket
+        size_t offsets[RADIX_BUCKETS];
+        size_t total = 0;
+        bool constant_digit = false;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            size_t count = 0;
+            for (int c = 0; c < HISTOGRAM_COPIES; c++) {
+                count += hist[(d * HISTOGRAM_COPIES + c) * RADIX_BUCKETS + b];
+            }
+            if (count == n) constant_digit = true;
+            offsets[b] = total;
+            total += count;
+        }
+
+        // Every order has the same value for this digit: the pass would not move anything
+        if (constant_digit) continue;
+
+        // Stable scatter into the other buffer
+        int shift = d * RADIX_BITS;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t key = static_cast<uint64_t>(src[i].timestamp) - static_cast<uint64_t>(min_ts);
+            dst[offsets[(key >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+        }
+        swap(src, dst);
+    }
+
+    // After an odd number of passes the result sits in the auxiliary buffer
+    if (src != orders) {
+        copy(src, src + n, orders);
+    }
+}
+
+// Function to sort all orders with the chosen serial algorithm
+// Parameters:
+// - orders: The array of orders to be sorted
+// - n: Number of orders
+// - algo: "merge", "pingpong" or "radix"
+void sort_orders(Order* orders, size_t n, const string& algo) {
+    if (algo == "pingpong") {
+        pingpong_merge_sort(orders, n);
+    } else if (algo == "radix") {
+        radix_sort(orders, n);
+    } else if (n > 0) {
+        merge_sort(orders, 0, static_cast<ptrdiff_t>(n) - 1);
+    }
+}
+
 // Function to generate a vector of sample orders with random timestamps
 // Parameters:
 // - orders: Reference to the vector where orders will be stored
@@ -147,8 +539,638 @@ void print_first_n_orders(const vector<Order>& orders, int n) {
     }
 }
 
+// Function to fill in an order file header
+// Parameters:
+// - count: Number of records in the file
+// - base_time: Earliest timestamp in the file
+OrderFileHeader make_order_file_header(uint64_t count, time_t base_time) {
+    OrderFileHeader header = {};
+    memcpy(header.magic, "ORDF", 4);
+    header.version = ORDER_FILE_VERSION;
+    header.count = count;
+    header.base_time = base_time;
+    return header;
+}
+
+// Function to check an order file header against the file it came from
+// Parameters:
+// - header: The header read from the file
+// - file_bytes: Total size of the file in bytes
+// - path: File name used in error messages
+// Returns true if the header is valid and the file holds exactly header.count records.
+bool check_order_file_header(const OrderFileHeader& header, long long file_bytes, const string& path) {
+    if (file_bytes < static_cast<long long>(sizeof(OrderFileHeader)) || memcmp(header.magic, "ORDF", 4) != 0 ||
+        header.version != ORDER_FILE_VERSION) {
+        cout << "Error: " << path << " is not an order file." << endl;
+        return false;
+    }
+    if (header.count != (file_bytes - sizeof(OrderFileHeader)) / sizeof(Order) ||
+        (file_bytes - sizeof(OrderFileHeader)) % sizeof(Order) != 0) {
+        cout << "Error: " << path << " is truncated or has trailing bytes." << endl;
+        return false;
+    }
+    return true;
+}
+
+// Function to read packed orders from a file, counting the bytes read
+// Parameters:
+// - file: Open binary file positioned at the first record to read
+// - buf: Destination buffer
+// - count: Maximum number of orders to read
+// Returns the number of orders actually read.
+size_t read_orders(FILE* file, Order* buf, size_t count) {
+    size_t got = fread(buf, sizeof(Order), count, file);
+    bytes_read += got * sizeof(Order);
+    return got;
+}
+
+// Function to write packed orders to a file, counting the bytes written
+// Parameters:
+// - file: Open binary file
+// - buf: Orders to write
+// - count: Number of orders to write
+// Returns true if every order was written.
+bool write_orders(FILE* file, const Order* buf, size_t count) {
+    size_t put = fwrite(buf, sizeof(Order), count, file);
+    bytes_written += put * sizeof(Order);
+    return put == count;
+}
+
+// Background thread that performs one block transfer at a time for a RunReader or
+// RunWriter, kept for the owner's lifetime instead of starting a thread per block
+class BlockWorker {
+public:
+    BlockWorker() : worker([this]() { loop(); }) {}
+
+    ~BlockWorker() {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+        wake.notify_all();
+        worker.join();
+    }
+
+    // Start a transfer in the background (the previous one must have been waited for)
+    void start(function<size_t()> job) {
+        {
+            lock_guard<mutex> lock(m);
+            task = move(job);
+            busy = true;
+        }
+        wake.notify_all();
+    }
+
+    // Wait for the transfer started last and return its result
+    size_t wait() {
+        unique_lock<mutex> lock(m);
+        wake.wait(lock, [this]() { return !busy; });
+        return result;
+    }
+
+private:
+    void loop() {
+        unique_lock<mutex> lock(m);
+        while (true) {
+            wake.wait(lock, [this]() { return task || stopping; });
+            if (!task) return;  // Stopping with nothing left to do
+            function<size_t()> job = move(task);
+            task = nullptr;
+            lock.unlock();
+            size_t done = job();
+            lock.lock();
+            result = done;
+            busy = false;
+            wake.notify_all();
+        }
+    }
+
+    mutex m;
+    condition_variable wake;
+    function<size_t()> task;  // Transfer waiting to run (empty if none)
+    size_t result = 0;        // Result of the last finished transfer
+    bool busy = false;        // Whether a started transfer has not finished yet
+    bool stopping = false;
+    thread worker;            // Declared last so everything above exists when it starts
+};
+
+// Sequential reader over one sorted run of a run file
+// While the merge consumes the current block, the next block is read in the background.
+// A read that returns fewer orders than requested (an I/O error or a truncated file)
+// marks the reader as failed, so the merge cannot succeed with orders missing.
+class RunReader {
+public:
+    // Parameters:
+    // - path: Run file to read from
+    // - start: Index of the run's first order within the file
+    // - count: Number of orders in the run
+    // - block: Number of orders per read
+    RunReader(const string& path, long long start, long long count, size_t block)
+        : remaining(count), current(block), next(block) {
+        file = fopen(path.c_str(), "rb");
+        if (file) {
+            setvbuf(file, nullptr, _IONBF, 0);  // Blocks are already large; skip stdio's copy
+            failed = fseeko(file, sizeof(OrderFileHeader) + static_cast<off_t>(start) * sizeof(Order), SEEK_SET) != 0;
+            if (!failed) {
+                prefetch();
+                advance_block();
+            }
+        }
+    }
+
+    ~RunReader() {
+        if (in_flight) io.wait();
+        if (file) fclose(file);
+    }
+
+    bool ok() const { return file != nullptr && !failed; }
+    bool done() const { return pos == size; }
+    const Order& head() const { return current[pos]; }
+
+    // Move to the next order of the run
+    void advance() {
+        if (++pos == size) advance_block();
+    }
+
+private:
+    // Start reading the next block in the background
+    void prefetch() {
+        size_t want = static_cast<size_t>(min<long long>(next.size(), remaining));
+        remaining -= want;
+        requested = want;
+        in_flight = true;
+        io.start([this, want]() { return read_orders(file, next.data(), want); });
+    }
+
+    // Switch to the prefetched block and start reading the one after it
+    void advance_block() {
+        size = 0;
+        if (in_flight) {
+            size = io.wait();
+            in_flight = false;
+            if (size != requested) failed = true;
+        }
+        swap(current, next);
+        pos = 0;
+        if (size > 0 && remaining > 0 && !failed) prefetch();
+    }
+
+    FILE* file;
+    long long remaining;            // Orders of the run not yet requested from the file
+    vector<Order> current, next;    // Block being consumed and block being read
+    size_t pos = 0, size = 0;       // Position and fill of the current block
+    size_t requested = 0;           // Orders asked for by the read in flight
+    bool in_flight = false;         // Whether a background read into next is running
+    bool failed = false;            // Whether a seek or read came up short
+    BlockWorker io;                 // Thread that reads the blocks
+};
+
+// Sequential writer that flushes full blocks in the background while the next one fills
+class RunWriter {
+public:
+    // Parameters:
+    // - file: Open binary file to append to
+    // - block: Number of orders per write
+    RunWriter(FILE* file, size_t block) : file(file), current(block), flushing(block) {}
+
+    ~RunWriter() { wait(); }
+
+    // Append one order
+    void push(const Order& o) {
+        current[fill++] = o;
+        if (fill == current.size()) flush();
+    }
+
+    // Write out everything pushed so far; returns false if any write failed
+    bool finish() {
+        flush();
+        wait();
+        return ok;
+    }
+
+private:
+    void flush() {
+        if (fill == 0) return;
+        wait();  // The other buffer must be on disk before it is reused
+        swap(current, flushing);
+        size_t count = fill;
+        fill = 0;
+        in_flight = true;
+        io.start([this, count]() { return size_t(write_orders(file, flushing.data(), count)); });
+    }
+
+    void wait() {
+        if (in_flight && !io.wait()) ok = false;
+        in_flight = false;
+    }
+
+    FILE* file;
+    vector<Order> current, flushing;  // Block being filled and block being written
+    size_t fill = 0;
+    bool in_flight = false;           // Whether a background write of flushing is running
+    bool ok = true;
+    BlockWorker io;                   // Thread that writes the blocks
+};
+
+// Loser tree selecting the smallest head among k run readers
+// Internal node i (1 <= i < k) stores the loser of the match played there, leaves sit
+// at k..2k-1, and tree[0] holds the overall winner. Ties go to the lower run index,
+// so merging runs in file order keeps the sort stable.
+class LoserTree {
+public:
+    LoserTree(const vector<RunReader*>& runs) : runs(runs), k(runs.size()), tree(max(1, k), 0) {
+        tree[0] = (k == 1) ? 0 : build(1);
+    }
+
+    bool done() const { return runs[tree[0]]->done(); }
+    const Order& top() const { return runs[tree[0]]->head(); }
+
+    // Consume the current winner and replay its path to the root
+    void pop() {
+        int winner = tree[0];
+        runs[winner]->advance();
+        for (int node = (winner + k) / 2; node >= 1; node /= 2) {
+            if (beats(tree[node], winner)) swap(tree[node], winner);
+        }
+        tree[0] = winner;
+    }
+
+private:
+    // Whether run a's head comes before run b's head (exhausted runs always lose)
+    bool beats(int a, int b) const {
+        if (runs[a]->done()) return false;
+        if (runs[b]->done()) return true;
+        time_t ta = runs[a]->head().timestamp, tb = runs[b]->head().timestamp;
+        return ta < tb || (ta == tb && a < b);
+    }
+
+    // Play the initial matches below node and return the subtree's winner
+    int build(int node) {
+        if (node >= k) return node - k;
+        int l = build(2 * node), r = build(2 * node + 1);
+        if (beats(l, r)) {
+            tree[node] = r;
+            return l;
+        }
+        tree[node] = l;
+        return r;
+    }
+
+    vector<RunReader*> runs;
+    int k;
+    vector<int> tree;
+};
+
+// Function to sort an order file using at most mem_limit bytes of buffers
+// Run files carry the same header as the input so a single run can become the output.
+// Parameters:
+// - in_path: Input order file
+// - out_path: Output file for the sorted records
+// - mem_limit: Memory budget for run buffers and merge buffers in bytes
+// - algo: Serial algorithm used to sort each in-memory run
+// - total: Receives the number of orders in the file
+// - merge_passes: Receives the number of merge passes over the data
+// Returns true on success.
+bool external_sort(const string& in_path, const string& out_path, size_t mem_limit,
+                   const string& algo, long long& total, int& merge_passes) {
+    total = 0;
+    merge_passes = 0;
+
+    FILE* in = fopen(in_path.c_str(), "rb");
+    if (!in) {
+        cout << "Error: Cannot open " << in_path << " for reading." << endl;
+        return false;
+    }
+    fseeko(in, 0, SEEK_END);
+    long long file_bytes = ftello(in);
+    fseeko(in, 0, SEEK_SET);
+    OrderFileHeader header = {};
+    // A short read leaves the header zeroed, which the check rejects
+    size_t header_read = fread(&header, sizeof(header), 1, in);
+    if (!check_order_file_header(header, header_read == 1 ? file_bytes : 0, in_path)) {
+        fclose(in);
+        return false;
+    }
+    total = header.count;
+
+    // Run formation: half the budget holds the chunk, the other half the sort's buffer
+    size_t chunk_records = max<size_t>(1, mem_limit / (2 * sizeof(Order)));
+    chunk_records = static_cast<size_t>(min<long long>(chunk_records, max(1LL, total)));
+    string run_path[2] = {out_path + ".runs0", out_path + ".runs1"};
+    vector<pair<long long, long long>> runs;  // {first order, count} in the current run file
+    // Deletes both run files (on failure, so no temporaries are left behind)
+    auto remove_runs = [&run_path]() {
+        remove(run_path[0].c_str());
+        remove(run_path[1].c_str());
+    };
+
+    FILE* run_file = fopen(run_path[0].c_str(), "wb");
+    if (!run_file || fwrite(&header, sizeof(header), 1, run_file) != 1) {
+        if (run_file) fclose(run_file);
+        cout << "Error: Cannot create " << run_path[0] << "." << endl;
+        fclose(in);
+        remove_runs();
+        return false;
+    }
+    {
+        vector<Order> chunk(chunk_records);
+        record_auxiliary_space(2 * chunk_records * sizeof(Order));
+        long long written = 0;
+        size_t got;
+        while ((got = read_orders(in, chunk.data(), chunk_records)) > 0) {
+            chunk.resize(got);
+            sort_orders(chunk.data(), chunk.size(), algo);
+            if (!write_orders(run_file, chunk.data(), got)) {
+                cout << "Error: Writing " << run_path[0] << " failed." << endl;
+                fclose(in);
+                fclose(run_file);
+                remove_runs();
+                return false;
+            }
+            runs.push_back({written, static_cast<long long>(got)});
+            written += got;
+            chunk.resize(chunk_records);
+        }
+
+        // A short read is an I/O error, not the end of the input: the header said how many
+        bool read_failed = ferror(in) || written != total;
+        fclose(in);
+        bool run_failed = fclose(run_file) != 0;
+        if (read_failed || run_failed) {
+            cout << "Error: " << (read_failed ? "Reading " + in_path : "Writing " + run_path[0])
+                 << " failed after " << written << " of " << total << " orders." << endl;
+            remove_runs();
+            return false;
+        }
+    }
+
+    // Merge passes: each pass merges groups of up to fan_in consecutive runs
+    int current = 0;
+    while (runs.size() > 1) {
+        // Every input and the output get two blocks (current + prefetch)
+        size_t fan_in = mem_limit / (2 * MIN_IO_BLOCK);
+        fan_in = min(fan_in > 3 ? fan_in - 1 : 2, runs.size());
+        size_t block_bytes = min(MAX_IO_BLOCK, mem_limit / (2 * (fan_in + 1)));
+        size_t block = max<size_t>(1, block_bytes / sizeof(Order));
+        record_auxiliary_space(2 * (fan_in + 1) * block * sizeof(Order));
+
+        bool last_pass = runs.size() <= fan_in;
+        string target = last_pass ? out_path : run_path[1 - current];
+        FILE* out = fopen(target.c_str(), "wb");
+        if (out) setvbuf(out, nullptr, _IONBF, 0);  // Must precede the header write
+        if (!out || fwrite(&header, sizeof(header), 1, out) != 1) {
+            cout << "Error: Cannot create " << target << "." << endl;
+            if (out) fclose(out);
+            remove_runs();
+            return false;
+        }
+
+        vector<pair<long long, long long>> merged_runs;
+        long long written = 0;
+        bool ok = true;
+        for (size_t first = 0; first < runs.size(); first += fan_in) {
+            size_t last = min(runs.size(), first + fan_in);
+
+            vector<unique_ptr<RunReader>> readers;
+            vector<RunReader*> inputs;
+            long long count = 0;
+            for (size_t r = first; r < last; r++) {
+                readers.emplace_back(new RunReader(run_path[current], runs[r].first, runs[r].second, block));
+                ok = ok && readers.back()->ok();
+                inputs.push_back(readers.back().get());
+                count += runs[r].second;
+            }
+            if (!ok) break;
+
+            RunWriter writer(out, block);
+            LoserTree tree(inputs);
+            while (!tree.done()) {
+                writer.push(tree.top());
+                tree.pop();
+            }
+            ok = writer.finish();
+            for (auto& reader : readers) ok = ok && reader->ok();  // No run may end early
+            if (!ok) break;
+
+            merged_runs.push_back({written, count});
+            written += count;
+        }
+        fclose(out);
+        if (!ok) {
+            cout << "Error: Merging into " << target << " failed." << endl;
+            remove_runs();
+            return false;
+        }
+
+        remove(run_path[current].c_str());
+        runs = merged_runs;
+        merge_passes++;
+        if (!last_pass) current = 1 - current;
+    }
+
+    // A single run (or an empty input) is already the sorted file
+    if (merge_passes == 0) {
+        remove(out_path.c_str());
+        if (rename(run_path[0].c_str(), out_path.c_str()) != 0) {
+            cout << "Error: Cannot create " << out_path << "." << endl;
+            remove_runs();
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function to sort an order file in place through a shared memory mapping
+// Parameters:
+// - path: Order file to sort
+// - algo: Serial algorithm used for the sort
+// - total: Receives the number of orders in the file
+// - map_time: Receives the seconds spent opening and mapping the file
+// - sort_time: Receives the seconds spent sorting and syncing the mapping
+// Returns true on success.
+bool mapped_sort(const string& path, const string& algo, long long& total, double& map_time, double& sort_time) {
+    auto start = chrono::steady_clock::now();
+
+    int fd = open(path.c_str(), O_RDWR);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        cout << "Error: Cannot open " << path << " for reading and writing." << endl;
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    size_t file_bytes = info.st_size;
+
+    // Map the whole file; writes go straight back to it
+    void* mapping = file_bytes > 0 ? mmap(nullptr, file_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);  // The mapping keeps the file open
+    if (mapping == MAP_FAILED) {
+        cout << "Error: Cannot map " << path << "." << endl;
+        return false;
+    }
+
+    OrderFileHeader header = {};
+    if (file_bytes >= sizeof(header)) memcpy(&header, mapping, sizeof(header));
+    if (!check_order_file_header(header, file_bytes, path)) {
+        munmap(mapping, file_bytes);
+        return false;
+    }
+    total = header.count;
+    Order* orders = reinterpret_cast<Order*>(static_cast<char*>(mapping) + sizeof(OrderFileHeader));
+    auto mapped = chrono::steady_clock::now();
+
+    // Sort the records where they lie and flush the dirty pages to the file
+    sort_orders(orders, total, algo);
+    bool synced = msync(mapping, file_bytes, MS_SYNC) == 0;
+    auto end = chrono::steady_clock::now();
+
+    munmap(mapping, file_bytes);
+    map_time = chrono::duration<double>(mapped - start).count();
+    sort_time = chrono::duration<double>(end - mapped).count();
+    if (!synced) {
+        cout << "Error: Writing the sorted records back to " << path << " failed." << endl;
+        return false;
+    }
+    return true;
+}
+
+// Function to read up to n orders from the start of an order file (for display)
+// Parameters:
+// - path: Order file to read
+// - n: Maximum number of orders to read
+vector<Order> read_first_orders(const string& path, size_t n) {
+    vector<Order> head(n);
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file || fseeko(file, sizeof(OrderFileHeader), SEEK_SET) != 0) {
+        head.clear();
+    } else {
+        head.resize(fread(head.data(), sizeof(Order), n, file));
+    }
+    if (file) fclose(file);
+    return head;
+}
+
+// Function to report the peak resident set size of this process in bytes
+long long peak_rss_bytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<long long>(usage.ru_maxrss) * 1024;  // ru_maxrss is in kilobytes on Linux
+}
+
+// Function to parse a byte count with an optional K, M or G suffix (e.g. 512M)
+// Parameters:
+// - text: The text to parse
+size_t parse_bytes(const string& text) {
+    size_t pos = 0;
+    unsigned long long value = stoull(text, &pos);
+    if (pos < text.size()) {
+        char unit = toupper(text[pos]);
+        if (unit == 'K') value <<= 10;
+        else if (unit == 'M') value <<= 20;
+        else if (unit == 'G') value <<= 30;
+    }
+    return value;
+}
+
 // Main function: Entry point of the program
-int main() {
+int main(int argc, char* argv[]) {
+    // Number of threads for the parallel run (0 = serial only)
+    int max_threads = 0;
+
+    // Serial sorting algorithm: "merge" (merge_sort), "pingpong" (pingpong_merge_sort)
+    // or "radix" (radix_sort)
+    string algo = "merge";
+
+    // Files for the external sort and for writing generated orders
+    string external_input, external_output, generate_path, mapped_path;
+
+    // Memory budget for the external sort (bytes)
+    size_t mem_limit = 256ULL << 20;
+
+    // Parse optional command-line flags
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--threads=", 0) == 0) {
+            max_threads = stoi(arg.substr(10));
+            if (max_threads <= 0) max_threads = thread::hardware_concurrency();
+        } else if (arg.rfind("--cutoff=", 0) == 0) {
+            parallel_cutoff = max(1, stoi(arg.substr(9)));
+        } else if (arg.rfind("--algo=", 0) == 0 && (arg.substr(7) == "merge" || arg.substr(7) == "pingpong" ||
+                                              arg.substr(7) == "radix")) {
+            algo = arg.substr(7);
+        } else if (arg.rfind("--external=", 0) == 0) {
+            external_input = arg.substr(11);
+        } else if (arg.rfind("--output=", 0) == 0) {
+            external_output = arg.substr(9);
+        } else if (arg.rfind("--mem-limit=", 0) == 0) {
+            mem_limit = max<size_t>(parse_bytes(arg.substr(12)), 2 * sizeof(Order));
+        } else if (arg.rfind("--generate=", 0) == 0) {
+            generate_path = arg.substr(11);
+        } else if (arg.rfind("--mmap=", 0) == 0) {
+            mapped_path = arg.substr(7);
+        } else {
+            cout << "Usage: " << argv[0] << " [--algo=merge|pingpong|radix] [--threads=N] [--cutoff=N]\n"
+                 << "       " << argv[0] << " --external=FILE [--output=FILE] [--mem-limit=BYTES[K|M|G]] [--algo=...]\n"
+                 << "       " << argv[0] << " --mmap=FILE [--algo=...]\n"
+                 << "       " << argv[0] << " --generate=FILE" << endl;
+            return 1;
+        }
+    }
+
+    // External mode: sort a file of packed orders instead of generated ones
+    if (!external_input.empty()) {
+        if (external_output.empty()) external_output = external_input + ".sorted";
+
+        cout << "Sorting " << external_input << " into " << external_output
+             << " with a " << mem_limit << "-byte memory limit...\n";
+        long long total;
+        int merge_passes;
+        auto start = chrono::steady_clock::now();
+        if (!external_sort(external_input, external_output, mem_limit, algo, total, merge_passes)) return 1;
+        auto end = chrono::steady_clock::now();
+        cout << "Done!\n";
+
+        double time_taken = chrono::duration<double>(end - start).count();
+        cout << "\nTime taken to sort " << total << " orders: "
+             << fixed << setprecision(2) << time_taken << " seconds.\n";
+
+        // Show the head of the sorted file
+        print_first_n_orders(read_first_orders(external_output, 5), 5);
+
+        cout << "\n--- Space Complexity Report ---\n";
+        cout << "Size of one Order object: " << sizeof(Order) << " bytes\n";
+        cout << "Total input size: " << total * sizeof(Order) << " bytes\n";
+        cout << "Memory limit: " << mem_limit << " bytes\n";
+        cout << "Peak auxiliary space used: " << max_auxiliary_space << " bytes\n";
+        cout << "Bytes read: " << bytes_read << "\n";
+        cout << "Bytes written: " << bytes_written << "\n";
+        cout << "Merge passes: " << merge_passes << "\n";
+        cout << "Peak resident set size: " << peak_rss_bytes() << " bytes\n";
+        return 0;
+    }
+
+    // Mapped mode: sort an order file in place
+    if (!mapped_path.empty()) {
+        cout << "Sorting " << mapped_path << " in place through a memory mapping...\n";
+        long long total;
+        double map_time, time_taken;
+        if (!mapped_sort(mapped_path, algo, total, map_time, time_taken)) return 1;
+        cout << "Done!\n";
+
+        cout << "\nTime taken to map " << total << " orders: "
+             << fixed << setprecision(2) << map_time << " seconds.\n";
+        cout << "Time taken to sort " << total << " orders: " << time_taken << " seconds.\n";
+        cout << "Throughput: " << static_cast<long long>(time_taken > 0 ? total / time_taken : 0) << " records/sec\n";
+
+        print_first_n_orders(read_first_orders(mapped_path, 5), 5);
+
+        cout << "\n--- Space Complexity Report ---\n";
+        cout << "Size of one Order object: " << sizeof(Order) << " bytes\n";
+        cout << "Total input size: " << total * sizeof(Order) << " bytes\n";
+        cout << "Peak auxiliary space used: " << max_auxiliary_space << " bytes\n";
+        cout << "Peak resident set size: " << peak_rss_bytes() << " bytes\n";
+        return 0;
+    }
+
     // Seed the random number generator with the current time for randomness
     srand(time(nullptr));
 
@@ -172,22 +1194,87 @@ int main() {
     cout << "\nGenerating " << num_orders << " orders...\n";
     generate_sample_orders(orders, num_orders);
 
-    // Start sorting and measure time
-    cout << "Sorting orders using Merge Sort...\n";
-    clock_t start = clock();  // Record start time
+    // Save the unsorted orders as an order file for --external or --mmap
+    if (!generate_path.empty()) {
+        time_t base_time = orders[0].timestamp;
+        for (const Order& o : orders) base_time = min(base_time, o.timestamp);
+        OrderFileHeader header = make_order_file_header(orders.size(), base_time);
 
-    // Perform merge sort if there are orders to sort
-    if (!orders.empty()) {
-        merge_sort(orders, 0, orders.size() - 1);
+        FILE* out = fopen(generate_path.c_str(), "wb");
+        if (!out || fwrite(&header, sizeof(header), 1, out) != 1 || !write_orders(out, orders.data(), orders.size())) {
+            cout << "Error: Cannot write " << generate_path << "." << endl;
+            if (out) fclose(out);
+            return 1;
+        }
+        fclose(out);
+        cout << "Wrote " << orders.size() << " orders to " << generate_path << ".\n";
+        return 0;
     }
 
-    clock_t end = clock();  // Record end time
+    // Keep an unsorted copy so every comparison run starts from the same input
+    vector<Order> unsorted;
+    if (max_threads > 0 || algo != "merge") unsorted = orders;
+
+    // Start sorting and measure wall-clock time (CPU time would add up across threads)
+    cout << "Sorting orders using "
+         << (algo == "pingpong" ? "Ping-Pong Merge Sort" : algo == "radix" ? "Radix Sort" : "Merge Sort") << "...\n";
+    size_t allocations_before = heap_allocations;  // Heap allocations so far
+    auto start = chrono::steady_clock::now();  // Record start time
+
+    // Perform the sort if there are orders to sort
+    sort_orders(orders.data(), orders.size(), algo);
+
+    auto end = chrono::steady_clock::now();  // Record end time
     cout << "Done!\n";
 
+    // Snapshot the sort's space usage before the parallel runs add their own
+    size_t sort_allocations = heap_allocations - allocations_before;
+    size_t sort_aux_space = max_auxiliary_space;
+
     // Calculate and display the time taken for sorting
-    double time_taken = static_cast<double>(end - start) / CLOCKS_PER_SEC;
+    double time_taken = chrono::duration<double>(end - start).count();
     cout << "\nTime taken to sort " << num_orders << " orders: "
          << fixed << setprecision(2) << time_taken << " seconds.\n";
+    cout << "Throughput: " << static_cast<long long>(time_taken > 0 ? num_orders / time_taken : 0) << " records/sec\n";
+
+    // Compare other algorithms against merge_sort() on the same input
+    if (algo != "merge") {
+        vector<Order> reference = unsorted;
+
+        auto ref_start = chrono::steady_clock::now();
+        merge_sort(reference.data(), 0, static_cast<ptrdiff_t>(reference.size()) - 1);
+        auto ref_end = chrono::steady_clock::now();
+        double ref_time = chrono::duration<double>(ref_end - ref_start).count();
+
+        if (!same_orders(reference, orders)) {
+            cout << "Error: " << algo << " sort differs from merge_sort().\n";
+            return 1;
+        }
+
+        cout << "merge_sort() on the same input: " << ref_time << " seconds, "
+             << static_cast<long long>(ref_time > 0 ? num_orders / ref_time : 0) << " records/sec ("
+             << (time_taken > 0 ? ref_time / time_taken : 0) << "x)\n";
+    }
+
+    // Rerun the sort in parallel with 1, 2, 4, ... max_threads threads
+    for (int threads = 1; max_threads > 0 && threads <= max_threads;
+         threads = (threads == max_threads) ? threads + 1 : min(threads * 2, max_threads)) {
+        vector<Order> trial = unsorted;
+
+        auto par_start = chrono::steady_clock::now();
+        parallel_merge_sort(trial, threads);
+        auto par_end = chrono::steady_clock::now();
+        double par_time = chrono::duration<double>(par_end - par_start).count();
+
+        // The parallel result must match the serial one record for record
+        if (!same_orders(trial, orders)) {
+            cout << "Error: parallel sort with " << threads << " threads differs from the serial sort.\n";
+            return 1;
+        }
+
+        cout << "Time taken with " << setw(3) << threads << " thread(s): " << par_time
+             << " seconds (speedup " << (par_time > 0 ? time_taken / par_time : 0) << "x)\n";
+    }
 
     // Print the first 5 sorted orders
     print_first_n_orders(orders, 5);
@@ -196,7 +1283,9 @@ int main() {
     cout << "\n--- Space Complexity Report ---\n";
     cout << "Size of one Order object: " << sizeof(Order) << " bytes\n";
     cout << "Total input size: " << orders.size() * sizeof(Order) << " bytes\n";
-    cout << "Peak auxiliary space used: " << max_auxiliary_space << " bytes\n";
+    cout << "Peak auxiliary space used: " << sort_aux_space << " bytes\n";
+    cout << "Heap allocations during sort: " << sort_allocations << "\n";
+    cout << "Peak resident set size: " << peak_rss_bytes() << " bytes\n";
 
     return 0;  // Successful execution
 }
@@ -6,7 +6,46 @@
  * algorithm, and displays the top 10 sorted movies. It also measures and reports the sorting
  * time using high-resolution timing.
  *
- * Key concepts: Quick sort, file I/O, CSV parsing, user input handling, time measurement.
+ * The movies are sorted with introSorter(), a pattern-defeating quick sort templated on
+ * the comparison function: ninther pivot selection, three-way partitioning so runs of
+ * equal keys are finished in one pass, insertion sort for small ranges, a heap sort
+ * fallback when the recursion gets too deep, and recursion on the smaller side only.
+ * The movies are sorted in place with the plain byXxx comparator, so runs of equal keys
+ * really are grouped and finished in one pass. The original quickSorter() is timed on
+ * the same input for comparison when it has at most BASELINE_DEFAULT_LIMIT movies, or
+ * BASELINE_LIMIT with --compare-baseline (it is O(n^2) and recurses once per element on
+ * runs of equal keys, so larger inputs could overflow the stack).
+ *
+ * --csv=FILE loads the movies from a CSV file (title,rating,releaseYear,views, with an
+ * optional header line and double-quoted titles) instead of the built-in sample list.
+ * The file is memory-mapped, fields are found with a vectorized delimiter scan, numbers
+ * are parsed in place with from_chars, and titles are copied into one arena per thread
+ * rather than one string allocation per movie. --threads=N splits the file into N
+ * pieces at line boundaries and parses them in parallel. Parse throughput is reported
+ * separately from the sort time.
+ *
+ * The listed movies (the last 10, or --top=K) are found by topKSelector(), which
+ * replays quickSorter()'s partitions but only follows the ranges that reach the listed
+ * slots, as quickselect does. The listing, ties included, is therefore exactly the one
+ * the original program printed, at O(n) expected cost; the full sort is checked key by
+ * key against it and both timings are shown side by side. --topk skips the full sort.
+ *
+ * The movies are also copied into a columnar MovieTable (one array per attribute and a
+ * single title arena) and sorted by index: each row becomes a 64-bit integer holding
+ * the order-preserving bits of its key above its row id, and those integers are radix
+ * sorted, so no title is ever moved. --columnar prints the list through the resulting
+ * permutation: the same keys as the default listing, with tied movies in row order.
+ * --random=N replaces the sample list with N synthetic movies for timing large inputs.
+ *
+ * --sort="rating desc, views desc, year asc" sorts by a compound specification instead
+ * of asking for one attribute. The specification is compiled once into a 128-bit key
+ * per movie (the order-preserving bits of each attribute, inverted for descending,
+ * followed by the row id), so the sort compares two integers per pair. The same sort
+ * with a chain of byXxx comparators is timed for comparison; a single-attribute spec
+ * orders exactly like the matching byXxx function.
+ *
+ * Key concepts: Quick sort, introsort, file I/O, CSV parsing, user input handling,
+ * time measurement.
  */
 
 #include <iostream>     // For input/output operations (cin, cout, cerr)
@@ -17,13 +56,26 @@
 #include <chrono>       // For high-resolution timing (high_resolution_clock, duration)
 #include <algorithm>    // For string transformations (transform, ::tolower)
 #include <cmath>        // For mathematical functions (though not heavily used here)
+#include <string_view>  // For titles stored in a shared arena (string_view)
+#include <charconv>     // For in-place number parsing (from_chars)
+#include <cstring>      // For line scanning (memchr, strncasecmp)
+#include <thread>       // For parallel parsing (thread)
+#include <cstdint>      // For packed sort keys (uint32_t, uint64_t)
+#include <random>       // For synthetic movies (mt19937)
+#include <fcntl.h>      // For opening the CSV file (open)
+#include <unistd.h>     // For closing the CSV file (close)
+#include <sys/mman.h>   // For mapping the CSV file (mmap, madvise, munmap)
+#include <sys/stat.h>   // For the CSV file size (fstat)
+#ifdef __SSE2__
+#include <emmintrin.h>  // For the vectorized delimiter scan (SSE2)
+#endif
 
 using namespace std;           // Use the standard namespace
 using namespace std::chrono;   // Use chrono namespace for timing
 
 // Structure to represent a movie with its attributes
 struct Movie {
-    string title;       // Title of the movie
+    string_view title;  // Title of the movie (points into a literal or a title arena)
     float rating;       // Rating score (e.g., IMDb rating)
     int releaseYear;    // Year the movie was released
     int views;          // Number of views or popularity metric
@@ -67,6 +119,474 @@ void quickSorter(vector<Movie> &data, int low, int high, bool (*compare)(const M
     quickSorter(data, pivotPos + 1, high, compare);
 }
 
+// Movies loaded from a CSV file; every title points into one of the arenas
+struct MovieCatalog {
+    vector<Movie> movies;          // Parsed movies in file order
+    vector<vector<char>> arenas;   // Title storage, one arena per parsing thread
+    size_t bytes = 0;              // Size of the CSV file in bytes
+    size_t skippedLines = 0;       // Lines that could not be parsed
+};
+
+// Function to find the first ',', '"' or newline in [p, end) (end if there is none)
+// Sixteen bytes are compared at a time when SSE2 is available.
+const char *findDelimiter(const char *p, const char *end) {
+#ifdef __SSE2__
+    const __m128i comma = _mm_set1_epi8(','), quote = _mm_set1_epi8('"'), newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, comma), _mm_cmpeq_epi8(chunk, quote)),
+                                    _mm_cmpeq_epi8(chunk, newline));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask != 0) return p + __builtin_ctz(mask);
+        p += 16;
+    }
+#endif
+    while (p < end && *p != ',' && *p != '"' && *p != '\n') p++;
+    return p;
+}
+
+// Function to parse one CSV line into a movie, appending its title to the arena
+// Parameters:
+// - p: Start of the line
+// - end: End of the line (excluding the newline)
+// - movie: Receives the parsed movie
+// - arena: Title storage (must have spare capacity for the whole line)
+// Returns false (leaving the arena unchanged) if the line is malformed.
+bool parseMovieLine(const char *p, const char *end, Movie &movie, vector<char> &arena) {
+    size_t titleStart = arena.size();
+    bool ok = true;
+
+    if (p < end && *p == '"') {
+        // Quoted title: "" inside the quotes stands for one quote character
+        p++;
+        while (true) {
+            const char *q = static_cast<const char *>(memchr(p, '"', end - p));
+            if (!q) { ok = false; break; }
+            arena.insert(arena.end(), p, q);
+            if (q + 1 < end && q[1] == '"') {
+                arena.push_back('"');
+                p = q + 2;
+            } else {
+                p = q + 1;
+                break;
+            }
+        }
+    } else {
+        const char *q = findDelimiter(p, end);
+        arena.insert(arena.end(), p, q);
+        p = q;
+    }
+    ok = ok && p < end && *p == ',';
+
+    // Numeric fields are parsed straight out of the mapped file
+    if (ok) {
+        auto r = from_chars(p + 1, end, movie.rating);
+        ok = r.ec == errc() && r.ptr < end && *r.ptr == ',';
+        if (ok) {
+            r = from_chars(r.ptr + 1, end, movie.releaseYear);
+            ok = r.ec == errc() && r.ptr < end && *r.ptr == ',';
+        }
+        if (ok) {
+            r = from_chars(r.ptr + 1, end, movie.views);
+            ok = r.ec == errc();
+            // Only trailing whitespace (such as the '\r' of a CRLF line) may follow
+            for (p = r.ptr; ok && p < end; p++) ok = (*p == ' ' || *p == '\r' || *p == '\t');
+        }
+    }
+
+    if (!ok) {
+        arena.resize(titleStart);
+        return false;
+    }
+    movie.title = string_view(arena.data() + titleStart, arena.size() - titleStart);
+    return true;
+}
+
+// Function to parse every line in [begin, end) (a range of whole lines)
+// Parameters:
+// - begin, end: The range to parse
+// - movies: Receives the parsed movies
+// - arena: Receives the titles
+// - skipped: Receives the number of malformed lines
+void parseMovieRange(const char *begin, const char *end, vector<Movie> &movies, vector<char> &arena, size_t &skipped) {
+    // Titles never take more bytes than the text they come from, so the arena is never
+    // reallocated and the string_views handed out stay valid
+    arena.reserve(end - begin);
+    skipped = 0;
+
+    for (const char *p = begin; p < end;) {
+        const char *lineEnd = static_cast<const char *>(memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+
+        Movie movie;
+        if (parseMovieLine(p, lineEnd, movie, arena)) {
+            movies.push_back(movie);
+        } else if (lineEnd > p && !(lineEnd == p + 1 && *p == '\r')) {
+            skipped++;  // Blank lines are not counted as errors
+        }
+        p = lineEnd + 1;
+    }
+}
+
+// Function to load movies from a CSV file
+// Parameters:
+// - path: The CSV file
+// - threads: Number of threads to parse with
+// - catalog: Receives the movies and their title arenas
+// Returns true on success.
+bool loadMovies(const string &path, int threads, MovieCatalog &catalog) {
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        cerr << "Error: Cannot open " << path << endl;
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    catalog.bytes = info.st_size;
+    if (catalog.bytes == 0) {
+        close(fd);
+        return true;
+    }
+
+    void *mapping = mmap(nullptr, catalog.bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps the file open
+    if (mapping == MAP_FAILED) {
+        cerr << "Error: Cannot map " << path << endl;
+        return false;
+    }
+    madvise(mapping, catalog.bytes, MADV_SEQUENTIAL);
+
+    const char *begin = static_cast<const char *>(mapping);
+    const char *end = begin + catalog.bytes;
+
+    // Skip a header line such as "title,rating,releaseYear,views"
+    if (catalog.bytes >= 6 && strncasecmp(begin, "title,", 6) == 0) {
+        const char *nl = static_cast<const char *>(memchr(begin, '\n', end - begin));
+        begin = nl ? nl + 1 : end;
+    }
+
+    // Cut the file into one piece per thread, moving each cut to just after a newline
+    threads = max(1, threads);
+    vector<const char *> cuts(threads + 1, end);
+    cuts[0] = begin;
+    for (int t = 1; t < threads; t++) {
+        const char *cut = max(cuts[t - 1], begin + (end - begin) * t / threads);
+        const char *nl = cut > begin ? static_cast<const char *>(memchr(cut - 1, '\n', end - cut + 1)) : cut - 1;
+        cuts[t] = nl ? nl + 1 : end;
+    }
+
+    // Parse the pieces in parallel, each into its own vector and arena
+    vector<vector<Movie>> parts(threads);
+    vector<size_t> skipped(threads, 0);
+    catalog.arenas.assign(threads, vector<char>());
+    vector<thread> workers;
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(parseMovieRange, cuts[t], cuts[t + 1], ref(parts[t]), ref(catalog.arenas[t]), ref(skipped[t]));
+    }
+    parseMovieRange(cuts[0], cuts[1], parts[0], catalog.arenas[0], skipped[0]);
+    for (auto &w : workers) w.join();
+    munmap(mapping, catalog.bytes);
+
+    // Stitch the pieces together in file order
+    size_t total = 0;
+    for (auto &part : parts) total += part.size();
+    catalog.movies.reserve(total);
+    for (int t = 0; t < threads; t++) {
+        catalog.movies.insert(catalog.movies.end(), parts[t].begin(), parts[t].end());
+        catalog.skippedLines += skipped[t];
+    }
+    return true;
+}
+
+// Column-oriented copy of a movie list: one array per attribute, titles in one arena
+struct MovieTable {
+    vector<float> rating;          // Rating of each row
+    vector<int> releaseYear;       // Release year of each row
+    vector<int> views;             // Views of each row
+    vector<char> titles;           // All titles back to back
+    vector<size_t> titleStart;     // Offset of each row's title in titles (plus an end marker)
+
+    size_t size() const { return rating.size(); }
+
+    string_view title(size_t row) const {
+        return string_view(titles.data() + titleStart[row], titleStart[row + 1] - titleStart[row]);
+    }
+
+    // Display one row in the same format as Movie::display()
+    void display(size_t row) const {
+        cout << title(row) << " | Score: " << rating[row]
+             << " | Year: " << releaseYear[row]
+             << " | Popularity: " << views[row] << endl;
+    }
+};
+
+// Function to build a columnar table from a list of movies (rows keep the list order)
+MovieTable buildMovieTable(const vector<Movie> &movies) {
+    MovieTable table;
+    size_t n = movies.size(), titleBytes = 0;
+    for (auto &m : movies) titleBytes += m.title.size();
+
+    table.rating.reserve(n);
+    table.releaseYear.reserve(n);
+    table.views.reserve(n);
+    table.titles.reserve(titleBytes);
+    table.titleStart.reserve(n + 1);
+    for (auto &m : movies) {
+        table.rating.push_back(m.rating);
+        table.releaseYear.push_back(m.releaseYear);
+        table.views.push_back(m.views);
+        table.titleStart.push_back(table.titles.size());
+        table.titles.insert(table.titles.end(), m.title.begin(), m.title.end());
+    }
+    table.titleStart.push_back(table.titles.size());
+    return table;
+}
+
+// Functions to map a key to 32 bits whose unsigned order matches the key's order
+uint32_t orderedBits(int value) { return static_cast<uint32_t>(value) ^ 0x80000000u; }
+uint32_t orderedBits(float value) {
+    if (value == 0) value = 0.0f;  // -0 compares equal to 0, so it must tie with it
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    // Negative floats order backwards, so flip all their bits; positives just gain the top bit
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+// Function to sort the table's rows by one attribute without touching the table
+// Every row becomes (key bits << 32 | row id). The row ids are already ascending, so a
+// stable LSD radix sort over the four key bytes alone leaves equal keys in row order,
+// just like a stable sort. Bytes that are the same in every key are skipped.
+// Parameters:
+// - table: The table to sort
+// - attribute: "rating", "year" or "views"
+// - descending: Whether larger keys come first
+// Returns the row ids in sorted order (the table must have fewer than 2^32 rows).
+vector<uint32_t> indexSorter(const MovieTable &table, const string &attribute, bool descending) {
+    size_t n = table.size();
+    vector<uint64_t> keys(n), buffer(n);
+    uint32_t flip = descending ? ~0u : 0u;
+    auto fill = [&](const auto &column) {
+        for (size_t row = 0; row < n; row++) {
+            keys[row] = (static_cast<uint64_t>(orderedBits(column[row]) ^ flip) << 32) | row;
+        }
+    };
+    if (attribute == "year") {
+        fill(table.releaseYear);
+    } else if (attribute == "views") {
+        fill(table.views);
+    } else {
+        fill(table.rating);
+    }
+
+    // Histograms of all four key bytes in one pass
+    size_t counts[4][256] = {};
+    for (uint64_t key : keys) {
+        for (int d = 0; d < 4; d++) counts[d][(key >> (32 + 8 * d)) & 0xFF]++;
+    }
+
+    for (int d = 0; d < 4; d++) {
+        size_t offsets[256], total = 0;
+        bool constantByte = false;
+        for (int b = 0; b < 256; b++) {
+            if (counts[d][b] == n) constantByte = true;
+            offsets[b] = total;
+            total += counts[d][b];
+        }
+        if (constantByte) continue;
+
+        int shift = 32 + 8 * d;
+        for (uint64_t key : keys) buffer[offsets[(key >> shift) & 0xFF]++] = key;
+        keys.swap(buffer);
+    }
+
+    // The low 32 bits of each sorted key are its row id
+    vector<uint32_t> permutation(n);
+    for (size_t i = 0; i < n; i++) permutation[i] = static_cast<uint32_t>(keys[i]);
+    return permutation;
+}
+
+// Function to fill a catalog with n synthetic movies (for timing large inputs)
+void generateMovies(size_t n, MovieCatalog &catalog) {
+    mt19937 rng(42);
+    catalog.arenas.assign(1, vector<char>());
+    vector<char> &arena = catalog.arenas[0];
+    arena.reserve(n * 16);  // Room for every "Movie <id>" title, so views stay valid
+    catalog.movies.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        string title = "Movie " + to_string(i);
+        size_t start = arena.size();
+        arena.insert(arena.end(), title.begin(), title.end());
+
+        Movie m;
+        m.title = string_view(arena.data() + start, title.size());
+        m.rating = (10 + rng() % 90) / 10.0f;           // 1.0 to 9.9
+        m.releaseYear = 1920 + static_cast<int>(rng() % 105);
+        m.views = static_cast<int>(rng() % 3000000);
+        catalog.movies.push_back(m);
+    }
+}
+
+// Largest input the original quickSorter() is timed on by default, and with
+// --compare-baseline (it degrades to O(n^2), with one stack frame per element, on the
+// long runs of equal ratings found in real catalogs)
+const size_t BASELINE_DEFAULT_LIMIT = 5000;
+const size_t BASELINE_LIMIT = 20000;
+
+// Ranges at or below this size are finished with insertion sort
+const int INSERTION_SORT_THRESHOLD = 24;
+
+// Ranges above this size pick the pivot as a ninther (median of three medians of three)
+const int NINTHER_THRESHOLD = 128;
+
+// Function to insertion sort data[low..high] using the comparator Less
+template <typename T, bool (*Less)(const T &, const T &)>
+void insertionSorter(vector<T> &data, int low, int high) {
+    for (int i = low + 1; i <= high; i++) {
+        T current = move(data[i]);
+        int j = i - 1;
+        // Shift larger movies one slot right
+        while (j >= low && Less(current, data[j])) {
+            data[j + 1] = move(data[j]);
+            j--;
+        }
+        data[j + 1] = move(current);
+    }
+}
+
+// Function to heap sort data[low..high] (used when the quick sort recursion is too deep)
+template <typename T, bool (*Less)(const T &, const T &)>
+void heapSorter(vector<T> &data, int low, int high) {
+    auto less = [](const T &x, const T &y) { return Less(x, y); };
+    make_heap(data.begin() + low, data.begin() + high + 1, less);
+    sort_heap(data.begin() + low, data.begin() + high + 1, less);
+}
+
+// Function to order data[a], data[b], data[c] so that data[b] holds their median
+template <typename T, bool (*Less)(const T &, const T &)>
+void sortThree(vector<T> &data, int a, int b, int c) {
+    if (Less(data[b], data[a])) swap(data[a], data[b]);
+    if (Less(data[c], data[b])) swap(data[b], data[c]);
+    if (Less(data[b], data[a])) swap(data[a], data[b]);
+}
+
+// Function to move a good pivot for data[low..high] into data[low]
+template <typename T, bool (*Less)(const T &, const T &)>
+void choosePivot(vector<T> &data, int low, int high) {
+    int mid = low + (high - low) / 2;
+    if (high - low + 1 > NINTHER_THRESHOLD) {
+        // Ninther: medians of three spread-out triples, then the median of those
+        int step = (high - low + 1) / 8;
+        sortThree<T, Less>(data, low, low + step, low + 2 * step);
+        sortThree<T, Less>(data, mid - step, mid, mid + step);
+        sortThree<T, Less>(data, high - 2 * step, high - step, high);
+        sortThree<T, Less>(data, low + step, mid, high - step);
+    } else {
+        sortThree<T, Less>(data, low, mid, high);
+    }
+    swap(data[low], data[mid]);
+}
+
+// Function to sort data[low..high] with introsort
+// Parameters:
+// - data: Reference to the vector to sort (movies or normalized sort keys)
+// - low: Starting index of the subarray to sort
+// - high: Ending index of the subarray to sort
+// - depthLimit: Partitioning rounds left before switching to heap sort
+template <typename T, bool (*Less)(const T &, const T &)>
+void introSortRange(vector<T> &data, int low, int high, int depthLimit) {
+    while (high - low + 1 > INSERTION_SORT_THRESHOLD) {
+        // Too many unbalanced partitions: heap sort guarantees O(n log n)
+        if (depthLimit-- == 0) {
+            heapSorter<T, Less>(data, low, high);
+            return;
+        }
+
+        choosePivot<T, Less>(data, low, high);
+        T pivotElement = data[low];
+
+        // Three-way partition: [low, lt) < pivot, [lt, i) == pivot, (gt, high] > pivot
+        int lt = low, i = low + 1, gt = high;
+        while (i <= gt) {
+            if (Less(data[i], pivotElement)) {
+                swap(data[lt++], data[i++]);
+            } else if (Less(pivotElement, data[i])) {
+                swap(data[i], data[gt--]);
+            } else {
+                i++;
+            }
+        }
+
+        // Recurse into the smaller side and loop on the larger one (O(log n) stack)
+        if (lt - low < high - gt) {
+            introSortRange<T, Less>(data, low, lt - 1, depthLimit);
+            low = gt + 1;
+        } else {
+            introSortRange<T, Less>(data, gt + 1, high, depthLimit);
+            high = lt - 1;
+        }
+    }
+    insertionSorter<T, Less>(data, low, high);
+}
+
+// Function to sort all elements with introsort using the comparator Less
+// Each comparator gets its own instantiation, so the comparison is inlined.
+template <typename T, bool (*Less)(const T &, const T &)>
+void introSorter(vector<T> &data) {
+    int depthLimit = 0;
+    for (size_t n = data.size(); n > 1; n >>= 1) depthLimit += 2;  // 2 * log2(n)
+    introSortRange<T, Less>(data, 0, (int)data.size() - 1, depthLimit);
+}
+
+// Function to select the k movies quickSorter() would list, best first
+// Replays quickSorter()'s partitions (last element as pivot, Lomuto scan) on a copy of
+// the movies, but like quickselect only goes on into the ranges that reach the last k
+// slots, so tied movies come out in exactly the order the original sort lists them.
+// A range whose movies all tie with its pivot is finished at once: quickSorter() ends
+// up rotating such a range right by one slot. The ranges are kept on an explicit
+// stack, so long runs of equal keys cannot overflow the call stack.
+// Parameters:
+// - data: The movies to select from (not modified)
+// - k: Number of movies to select
+// Returns the selected movies, best first.
+template <bool (*Less)(const Movie &, const Movie &)>
+vector<Movie> topKSelector(const vector<Movie> &data, size_t k) {
+    size_t n = data.size();
+    k = min(k, n);
+    if (k == 0) return vector<Movie>();
+
+    vector<Movie> work = data;
+    size_t first = n - k;  // First of the slots that are listed
+    vector<pair<size_t, size_t>> ranges = {{0, n - 1}};  // Inclusive [low, high]
+    while (!ranges.empty()) {
+        size_t low = ranges.back().first, high = ranges.back().second;
+        ranges.pop_back();
+        if (low >= high || high < first) continue;
+
+        // Partition exactly as quickSorter() does, noting whether every movie ties
+        Movie pivotElement = work[high];
+        size_t pivotPos = low;
+        bool allTied = true;
+        for (size_t j = low; j < high; j++) {
+            if (Less(work[j], pivotElement)) {
+                swap(work[j], work[pivotPos]);
+                pivotPos++;
+                allTied = false;
+            } else if (allTied && Less(pivotElement, work[j])) {
+                allTied = false;
+            }
+        }
+        if (allTied) {
+            rotate(work.begin() + low, work.begin() + high, work.begin() + high + 1);
+            continue;
+        }
+        swap(work[pivotPos], work[high]);
+        if (pivotPos > low) ranges.push_back({low, pivotPos - 1});
+        ranges.push_back({pivotPos + 1, high});
+    }
+
+    return vector<Movie>(work.rbegin(), work.rbegin() + k);  // Best first
+}
+
 // Comparison functions for sorting movies in ascending and descending order by different attributes
 // These functions are used as function pointers in the quick sort algorithm
 
@@ -88,12 +608,231 @@ bool byViewsAsc(const Movie &x, const Movie &y) { return x.views < y.views; }
 // Descending order by views
 bool byViewsDesc(const Movie &x, const Movie &y) { return x.views > y.views; }
 
+// One attribute of a compound sort specification
+struct SortField {
+    string attribute;  // "rating", "year" or "views"
+    bool descending;   // Whether larger values come first
+};
+
+// Normalized sort key: compares like the 16 bytes high:low in big-endian order
+struct SortKey {
+    uint64_t high;  // Bits of the first two fields
+    uint64_t low;   // Bits of the third field, then the row id
+};
+
+// Comparisons made by the counting spec sorts (for the per-pair cost report)
+size_t specComparisons = 0;
+
+// Comparator chain used by byChain() (the baseline for compound specs)
+vector<bool (*)(const Movie &, const Movie &)> activeChain;
+
+// Ascending order of normalized keys
+bool byKey(const SortKey &x, const SortKey &y) {
+    return x.high < y.high || (x.high == y.high && x.low < y.low);
+}
+
+// Order given by trying each comparator of activeChain in turn
+bool byChain(const Movie &x, const Movie &y) {
+    for (auto compare : activeChain) {
+        if (compare(x, y)) return true;
+        if (compare(y, x)) return false;
+    }
+    return false;
+}
+
+// Counting versions of byKey() and byChain(), run outside the timed sorts
+bool byKeyCounted(const SortKey &x, const SortKey &y) {
+    specComparisons++;
+    return byKey(x, y);
+}
+bool byChainCounted(const Movie &x, const Movie &y) {
+    specComparisons++;
+    return byChain(x, y);
+}
+
+// Functions to get the order-preserving bits of one attribute of a movie
+uint32_t ratingBits(const Movie &m) { return orderedBits(m.rating); }
+uint32_t yearBits(const Movie &m) { return orderedBits(m.releaseYear); }
+uint32_t viewsBits(const Movie &m) { return orderedBits(m.views); }
+
+// Function to parse a sort specification such as "rating desc, views desc, year asc"
+// Each comma-separated item is an attribute optionally followed by asc or desc (a
+// colon may stand in for the space); at most three distinct attributes are allowed.
+// Parameters:
+// - text: The specification
+// - fields: Receives the parsed fields
+// Returns false (after printing why) if the specification is invalid.
+bool parseSortSpec(const string &text, vector<SortField> &fields) {
+    fields.clear();
+    stringstream items(text);
+    string item;
+    while (getline(items, item, ',')) {
+        replace(item.begin(), item.end(), ':', ' ');
+        transform(item.begin(), item.end(), item.begin(), ::tolower);
+        stringstream words(item);
+        string attribute, direction = "asc", extra;
+        words >> attribute >> direction;
+        if (attribute.empty()) continue;
+        if ((attribute != "rating" && attribute != "year" && attribute != "views") ||
+            (direction != "asc" && direction != "desc") || (words >> extra)) {
+            cout << "Invalid sort item: \"" << item << "\"\n";
+            return false;
+        }
+        for (auto &f : fields) {
+            if (f.attribute == attribute) {
+                cout << "Attribute " << attribute << " appears twice in the sort specification.\n";
+                return false;
+            }
+        }
+        fields.push_back({attribute, direction == "desc"});
+    }
+    if (fields.empty()) {
+        cout << "Empty sort specification.\n";
+        return false;
+    }
+    return true;
+}
+
+// Function to compile a sort specification into one normalized key per movie
+// Each field contributes 32 order-preserving bits (inverted when descending) to a
+// 128-bit key, most significant field first; the row id fills the last 32 bits so
+// equal movies keep their input order.
+vector<SortKey> buildSortKeys(const vector<Movie> &movies, const vector<SortField> &fields) {
+    // Resolve each field to its bit extractor and direction once, before the row loop
+    size_t count = fields.size();
+    uint32_t (*extract[3])(const Movie &) = {};
+    uint32_t flip[3] = {0, 0, 0};
+    for (size_t f = 0; f < count; f++) {
+        extract[f] = fields[f].attribute == "year"  ? yearBits
+                   : fields[f].attribute == "views" ? viewsBits
+                                                    : ratingBits;
+        flip[f] = fields[f].descending ? ~0u : 0u;
+    }
+
+    vector<SortKey> keys(movies.size());
+    for (size_t row = 0; row < movies.size(); row++) {
+        uint32_t slots[3] = {0, 0, 0};
+        for (size_t f = 0; f < count; f++) slots[f] = extract[f](movies[row]) ^ flip[f];
+        keys[row].high = (static_cast<uint64_t>(slots[0]) << 32) | slots[1];
+        keys[row].low = (static_cast<uint64_t>(slots[2]) << 32) | static_cast<uint32_t>(row);
+    }
+    return keys;
+}
+
+// Function to sort by a compound specification and display the top entries
+// Parameters:
+// - movies: The movies to sort (not modified)
+// - spec: The sort specification text
+// - topK: Number of movies to display
+// Returns false if the specification is invalid or the two sort paths disagree.
+bool runSortSpec(const vector<Movie> &movies, const string &spec, int topK) {
+    vector<SortField> fields;
+    if (!parseSortSpec(spec, fields)) return false;
+
+    // Normalized keys: compile once, then integer comparisons only
+    auto begin = high_resolution_clock::now();
+    vector<SortKey> keys = buildSortKeys(movies, fields);
+    auto compiled = high_resolution_clock::now();
+    introSorter<SortKey, byKey>(keys);
+    auto end = high_resolution_clock::now();
+
+    // Baseline: the same sort through a chain of comparator function pointers
+    activeChain.clear();
+    for (auto &f : fields) {
+        if (f.attribute == "rating") activeChain.push_back(f.descending ? byRatingDesc : byRatingAsc);
+        if (f.attribute == "year") activeChain.push_back(f.descending ? byYearDesc : byYearAsc);
+        if (f.attribute == "views") activeChain.push_back(f.descending ? byViewsDesc : byViewsAsc);
+    }
+    vector<Movie> chained = movies;
+    auto chainBegin = high_resolution_clock::now();
+    introSorter<Movie, byChain>(chained);
+    auto chainEnd = high_resolution_clock::now();
+
+    // Count the comparisons of both sorts in untimed reruns on fresh copies
+    vector<SortKey> countedKeys = buildSortKeys(movies, fields);
+    specComparisons = 0;
+    introSorter<SortKey, byKeyCounted>(countedKeys);
+    size_t keyComparisons = specComparisons;
+    vector<Movie> countedMovies = movies;
+    specComparisons = 0;
+    introSorter<Movie, byChainCounted>(countedMovies);
+    size_t chainComparisons = specComparisons;
+
+    // Both orders must agree on every attribute of the spec
+    for (size_t i = 0; i < keys.size(); i++) {
+        const Movie &m = movies[static_cast<uint32_t>(keys[i].low)];
+        for (auto compare : activeChain) {
+            if (compare(m, chained[i]) || compare(chained[i], m)) {
+                cout << "Error: normalized-key sort disagrees with the comparator chain at position " << i << ".\n";
+                return false;
+            }
+        }
+    }
+
+    cout << "\n--- Top " << topK << " Movies Sorted by " << spec << " ---\n";
+    int lastIdx = max(0, (int)keys.size() - topK);
+    for (int i = keys.size() - 1; i >= lastIdx; --i) {
+        movies[static_cast<uint32_t>(keys[i].low)].display();
+    }
 
+    duration<double> compileTime = compiled - begin, keyTime = end - compiled, chainTime = chainEnd - chainBegin;
+    cout << "\nProcessed " << movies.size() << " entries in " << (compileTime + keyTime).count()
+         << " seconds (" << compileTime.count() << " compiling keys, " << keyTime.count() << " sorting).\n";
+    cout << "Normalized keys: " << keyComparisons << " comparisons, "
+         << (keyComparisons ? keyTime.count() * 1e9 / keyComparisons : 0) << " ns per compared pair.\n";
+    cout << "Comparator chain: " << chainTime.count() << " seconds, " << chainComparisons << " comparisons, "
+         << (chainComparisons ? chainTime.count() * 1e9 / chainComparisons : 0) << " ns per compared pair.\n";
+    return true;
+}
 
 // Main function: Entry point of the program
-int main() {
+int main(int argc, char *argv[]) {
+    // Optional CSV input and the number of threads used to parse it
+    string csvPath;
+    int parseThreads = 1;
+
+    // Number of movies to list, and whether to list them from the top-K selection
+    int topK = 10;
+    bool printTopK = false;
+
+    // Whether to list the movies through the columnar index sort, and the number of
+    // synthetic movies to use instead of the sample list (0 = none)
+    bool printColumnar = false;
+    size_t randomMovies = 0;
+
+    // Compound sort specification (empty = ask for a single attribute)
+    string sortSpec;
+
+    // Whether to also time the original quickSorter()
+    bool compareBaseline = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--csv=", 0) == 0) {
+            csvPath = arg.substr(6);
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            parseThreads = stoi(arg.substr(10));
+            if (parseThreads <= 0) parseThreads = thread::hardware_concurrency();
+        } else if (arg.rfind("--top=", 0) == 0) {
+            topK = max(1, stoi(arg.substr(6)));
+        } else if (arg == "--topk") {
+            printTopK = true;
+        } else if (arg == "--columnar") {
+            printColumnar = true;
+        } else if (arg.rfind("--random=", 0) == 0) {
+            randomMovies = stoull(arg.substr(9));
+        } else if (arg.rfind("--sort=", 0) == 0) {
+            sortSpec = arg.substr(7);
+        } else if (arg == "--compare-baseline") {
+            compareBaseline = true;
+        } else {
+            cout << "Usage: " << argv[0] << " [--csv=FILE | --random=N] [--threads=N] [--top=K]\n"
+                 << "       [--topk | --columnar | --sort=\"attribute asc|desc, ...\"] [--compare-baseline]" << endl;
+            return 1;
+        }
+    }
+
     // Hardcoded sample movie data
-    vector<Movie> movies = {
+    vector<Movie> sampleMovies = {
         {"The Shawshank Redemption", 9.3, 1994, 2343110},
         {"The Godfather", 9.2, 1972, 1620367},
         {"The Dark Knight", 9.0, 2008, 2303232},
@@ -126,6 +865,40 @@ int main() {
         {"Spirited Away", 8.6, 2001, 651376}
     };
 
+    // Load the CSV file if one was given, otherwise use the sample data
+    MovieCatalog catalog;
+    if (!csvPath.empty()) {
+        auto parseBegin = high_resolution_clock::now();
+        if (!loadMovies(csvPath, parseThreads, catalog)) return 1;
+        auto parseEnd = high_resolution_clock::now();
+
+        duration<double> parseTime = parseEnd - parseBegin;
+        double megabytes = catalog.bytes / 1e6;
+        cout << "Parsed " << catalog.movies.size() << " movies (" << megabytes << " MB) from " << csvPath
+             << " in " << parseTime.count() << " seconds ("
+             << (parseTime.count() > 0 ? megabytes / parseTime.count() : 0) << " MB/s, "
+             << parseThreads << " thread(s)).\n";
+        if (catalog.skippedLines > 0) {
+            cout << "Skipped " << catalog.skippedLines << " malformed line(s).\n";
+        }
+    }
+    if (csvPath.empty() && randomMovies > 0) {
+        generateMovies(randomMovies, catalog);
+    }
+    vector<Movie> &movies = (csvPath.empty() && randomMovies == 0) ? sampleMovies : catalog.movies;
+
+    // Sort keys hold the row id in their low 32 bits, so every row must fit there
+    if (movies.size() > UINT32_MAX) {
+        cout << "Error: " << movies.size() << " movies is more than the " << UINT32_MAX
+             << " rows a sort key can index.\n";
+        return 1;
+    }
+
+    // Compound specification: no prompts, sort by the spec instead
+    if (!sortSpec.empty()) {
+        return runSortSpec(movies, sortSpec, topK) ? 0 : 1;
+    }
+
     // Prompt user for the attribute to sort by
     cout << "Sort by which attribute? (rating/year/views): ";
     string userChoice;
@@ -140,44 +913,137 @@ int main() {
     // Convert input to lowercase
     transform(orderChoice.begin(), orderChoice.end(), orderChoice.begin(), ::tolower);
 
-    // Pointer to the comparison function based on user choices
+    // Pointer to the comparison function based on user choices, and the introsort
+    // instantiation specialized for it
     bool (*cmp)(const Movie &, const Movie &);
+    void (*sorter)(vector<Movie> &);
+    vector<Movie> (*selector)(const vector<Movie> &, size_t);
 
     // Select the appropriate comparison function
     if (userChoice == "rating") {
         cmp = (orderChoice == "desc") ? byRatingDesc : byRatingAsc;
+        sorter = (orderChoice == "desc") ? introSorter<Movie, byRatingDesc> : introSorter<Movie, byRatingAsc>;
+        selector = (orderChoice == "desc") ? topKSelector<byRatingDesc> : topKSelector<byRatingAsc>;
     } else if (userChoice == "year") {
         cmp = (orderChoice == "desc") ? byYearDesc : byYearAsc;
+        sorter = (orderChoice == "desc") ? introSorter<Movie, byYearDesc> : introSorter<Movie, byYearAsc>;
+        selector = (orderChoice == "desc") ? topKSelector<byYearDesc> : topKSelector<byYearAsc>;
     } else if (userChoice == "views") {
         cmp = (orderChoice == "desc") ? byViewsDesc : byViewsAsc;
+        sorter = (orderChoice == "desc") ? introSorter<Movie, byViewsDesc> : introSorter<Movie, byViewsAsc>;
+        selector = (orderChoice == "desc") ? topKSelector<byViewsDesc> : topKSelector<byViewsAsc>;
     } else {
         cout << "Invalid input! Default sorting by rating ascending.\n";
         cmp = byRatingAsc;  // Default to ascending rating
+        sorter = introSorter<Movie, byRatingAsc>;
+        selector = topKSelector<byRatingAsc>;
+    }
+
+    // Attribute and direction actually used (invalid input falls back to rating asc)
+    string sortAttribute = (userChoice == "year" || userChoice == "views") ? userChoice : "rating";
+    bool descending = (sortAttribute == userChoice) && orderChoice == "desc";
+
+    // Select the listed entries from the unsorted input (before the sort reorders it)
+    auto selectBegin = high_resolution_clock::now();
+    vector<Movie> topMovies = selector(movies, topK);
+    auto selectEnd = high_resolution_clock::now();
+    duration<double> selectTime = selectEnd - selectBegin;
+
+    cout << "\n--- Top " << topK << " Movies Sorted by " << userChoice
+         << " (" << orderChoice << ") ---\n";
+
+    // Top-K mode: list the selection without sorting everything
+    if (printTopK) {
+        for (auto &m : topMovies) m.display();  // Already best first
+        cout << "\nSelected the top " << topMovies.size() << " of " << movies.size() << " entries in "
+             << selectTime.count() << " seconds.\n";
+        return 0;
     }
 
+    // Build the columnar table and its sorted permutation from the unsorted input
+    auto tableBegin = high_resolution_clock::now();
+    MovieTable table = buildMovieTable(movies);
+    auto tableEnd = high_resolution_clock::now();
+    vector<uint32_t> permutation = indexSorter(table, sortAttribute, descending);
+    auto indexEnd = high_resolution_clock::now();
+
+    // Time the original quick sort on a copy of the same input (if it is small enough)
+    bool runBaseline = movies.size() <= (compareBaseline ? BASELINE_LIMIT : BASELINE_DEFAULT_LIMIT);
+    vector<Movie> baseline = runBaseline ? movies : vector<Movie>();
+    auto baselineBegin = high_resolution_clock::now();
+    quickSorter(baseline, 0, (int)baseline.size() - 1, cmp);
+    auto baselineEnd = high_resolution_clock::now();
+
     // Record the start time for performance measurement
     auto begin = high_resolution_clock::now();
 
-    // Perform quick sort on the movies vector
-    quickSorter(movies, 0, movies.size() - 1, cmp);
+    // Perform introsort on the movies vector
+    sorter(movies);
 
     // Record the end time
     auto end = high_resolution_clock::now();
 
-    // Display the top 10 movies (assuming descending order for "top")
-    cout << "\n--- Top 10 Movies Sorted by " << userChoice
-         << " (" << orderChoice << ") ---\n";
+    // Display the top movies, in the order quickSorter() lists them
+    if (printColumnar) {
+        // Walk the permutation from the end, like the sorted vector
+        int lastIdx = max(0, (int)permutation.size() - topK);
+        for (int i = permutation.size() - 1; i >= lastIdx; --i) {
+            table.display(permutation[i]);
+        }
+    } else {
+        for (auto &m : topMovies) m.display();  // Already best first
+    }
+
+    // The selection must list what quickSorter() lists, titles included
+    if (runBaseline) {
+        for (size_t r = 0; r < topMovies.size(); r++) {
+            const Movie &listed = baseline[baseline.size() - 1 - r];
+            if (listed.title != topMovies[r].title) {
+                cout << "Error: top-K selection disagrees with quickSorter() at rank " << r + 1 << ".\n";
+                return 1;
+            }
+        }
+    }
 
-    // Calculate the starting index for the last 10 movies
-    int lastIdx = max(0, (int)movies.size() - 10);
-    for (int i = movies.size() - 1; i >= lastIdx; --i) {
-        movies[i].display();  // Display each movie
+    // Every path must put the same keys in the same places (tied movies may differ)
+    for (size_t r = 0; r < topMovies.size(); r++) {
+        const Movie &sorted = movies[movies.size() - 1 - r];
+        if (cmp(sorted, topMovies[r]) || cmp(topMovies[r], sorted)) {
+            cout << "Error: top-K selection disagrees with the full sort at rank " << r + 1 << ".\n";
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < permutation.size(); i++) {
+        uint32_t row = permutation[i];
+        Movie fromTable = {table.title(row), table.rating[row], table.releaseYear[row], table.views[row]};
+        if (cmp(fromTable, movies[i]) || cmp(movies[i], fromTable)) {
+            cout << "Error: columnar index sort disagrees with the full sort at position " << i << ".\n";
+            return 1;
+        }
     }
 
     // Calculate and display the total time taken
     duration<double> totalTime = end - begin;
+    duration<double> baselineTime = baselineEnd - baselineBegin;
     cout << "\nProcessed " << movies.size() << " entries in "
-         << totalTime.count() << " seconds.\n";
+         << totalTime.count() << " seconds (full sort";
+    if (runBaseline) {
+        // Compare with the original quickSorter()
+        cout << ", " << (totalTime.count() > 0 ? baselineTime.count() / totalTime.count() : 0)
+             << "x faster than quickSorter()'s " << baselineTime.count() << " seconds";
+    }
+    cout << ") vs " << selectTime.count() << " seconds (top-" << topK << " selection).\n";
+    if (!runBaseline) {
+        cout << "quickSorter() not timed: more than "
+             << (compareBaseline ? BASELINE_LIMIT : BASELINE_DEFAULT_LIMIT) << " entries.\n";
+    }
+
+    // Compare with the columnar index sort
+    duration<double> tableTime = tableEnd - tableBegin;
+    duration<double> indexTime = indexEnd - tableEnd;
+    cout << "Columnar index sort: " << indexTime.count() << " seconds ("
+         << (indexTime.count() > 0 ? totalTime.count() / indexTime.count() : 0)
+         << "x speedup over introsort; building the table took " << tableTime.count() << " seconds).\n";
 
     return 0;  // Successful execution
 }
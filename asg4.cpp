@@ -6,6 +6,49 @@
  * It allows updating travel times due to traffic and finds the optimal route with the minimum
  * estimated time.
  *
+ * The city is stored as a compressed-sparse-row (CSR) graph: one offsets array and one
+ * packed array of {target, travel time} arcs, so a vertex's roads are contiguous and
+ * Dijkstra's scans stay in cache. --order=bfs or --order=rcm (reverse Cuthill-McKee)
+ * additionally renumbers the intersections so that neighbours get nearby numbers;
+ * distances and paths are reported in the original numbering and are identical to the
+ * unordered graph. --bench=V[,Q] builds a random road grid with V intersections and
+ * reports build time, memory and per-query latency of the adjacency list and the CSR
+ * layouts on Q random queries.
+ *
+ * The priority queue is pluggable: the original binary heap with lazy deletion, a
+ * radix heap, Dial's bucket queue (one bucket per distance modulo the largest travel
+ * time) or an indexed 4-ary heap with decrease-key. --queue=auto (the default) uses
+ * Dial's buckets when travel times are at most DIAL_MAX_WEIGHT and the radix heap
+ * otherwise; --stats prints push, decrease-key, pop and stale-pop counts.
+ *
+ * --dispatch picks how the nearest hospital is found: "full" runs Dijkstra over the
+ * whole graph and then scans the hospitals (the original method), "nearest" (the
+ * default) stops as soon as the nearest hospital is settled, and "table" runs one
+ * Dijkstra from all hospitals at once to give every intersection its nearest hospital,
+ * travel time and next hop, after which a dispatch just follows next hops.
+ *
+ * Each vertex's arcs are sorted by target, so a traffic update finds its road by
+ * binary search. DynamicPaths keeps the distances and shortest-path tree of one source
+ * and repairs them after a batch of traffic updates: vertices below a road that got
+ * slower are re-evaluated from their unaffected neighbours, roads that got faster seed
+ * improvements, and a Dijkstra pass spreads the changes (Ramalingam-Reps style).
+ * A batch that reaches a large part of the tree is recomputed instead.
+ * --update-bench=V[,B...] compares this repair with recomputation for batch sizes B.
+ *
+ * --dispatch=ch answers the query with a contraction hierarchy: vertices are contracted
+ * one by one (fewest added shortcuts first), adding a shortcut between two neighbours
+ * whenever no witness path avoids the contracted vertex. A query then only searches
+ * upwards in rank from both ends. --ch-file=PATH saves the hierarchy and reuses it on
+ * later runs over the same roads. --ch-bench=V[,Q] checks it against dijkstra() on
+ * random graphs and reports preprocessing time, index size and query latency.
+ *
+ * --dispatch=delta computes all distances with parallel delta-stepping instead of
+ * Dijkstra: vertices are kept in buckets of width --delta=D, each bucket is settled by
+ * rounds in which --threads=N threads relax its light roads (travel time <= D) with
+ * atomic minimum updates, and its heavy roads are relaxed once at the end. Parents are
+ * then chosen with Dijkstra's tie rule, so the result is identical. --delta-bench=V[,N]
+ * reports the scaling from 1 to N threads.
+ *
  * Key concepts: Dijkstra's algorithm, shortest path, priority queue, graph representation.
  */
 
@@ -14,6 +57,19 @@
 #include <queue>        // For priority queue
 #include <limits>       // For numeric limits (numeric_limits)
 #include <algorithm>    // For algorithms (though not heavily used here)
+#include <string>       // For command-line options (string)
+#include <iomanip>      // For benchmark output formatting (setprecision)
+#include <chrono>       // For benchmark timing (steady_clock, duration)
+#include <random>       // For generating benchmark road networks (mt19937)
+#include <cstdio>       // For hierarchy files (FILE, fopen, fread, fwrite)
+#include <cstdint>      // For fixed-size file fields (uint32_t, uint64_t)
+#include <cstring>      // For file magic (memcpy, memcmp)
+#include <thread>       // For delta-stepping worker threads (thread)
+#include <atomic>       // For concurrent distance updates (atomic)
+#include <mutex>        // For the worker team's hand-off (mutex, condition_variable)
+#include <condition_variable>
+#include <functional>   // For the worker team's task (function)
+#include <map>          // For the repaired tree's vertices by distance (map)
 
 using namespace std;  // Use the standard namespace
 
@@ -23,6 +79,19 @@ const int INT_MAX = numeric_limits<int>::max();
 // Type alias for a pair of integers (used for edges: {vertex, weight})
 typedef pair<int, int> iPair;
 
+// Largest travel time for which --queue=auto picks Dial's bucket queue
+const int DIAL_MAX_WEIGHT = 1024;
+
+// Most buckets delta-stepping keeps (narrower --delta widths are widened to fit)
+const int DELTA_MAX_BUCKETS = 1 << 16;
+
+// Vertices a witness search may settle before giving up (and adding the shortcut)
+const int WITNESS_SETTLE_LIMIT = 500;
+
+// A traffic repair that would settle more than 1/REPAIR_FRACTION of the vertices (or
+// redo the 0-minute ties of that many) recomputes them from the source instead
+const int REPAIR_FRACTION = 4;
+
 // Function to compute shortest paths from source using Dijkstra's algorithm
 // Parameters:
 // - src: Source vertex (starting point)
@@ -69,6 +138,1386 @@ void dijkstra(int src, const vector<vector<iPair>>& adj, vector<int>& dist, vect
     }
 }
 
+// A road as read from the input: u v travel time
+struct Road {
+    int u, v, w;
+};
+
+// An outgoing arc in the CSR graph
+struct Arc {
+    int to;      // Target vertex
+    int weight;  // Travel time
+};
+
+// Graph in compressed-sparse-row form. The arcs of vertex u are
+// arcs[offsets[u]] .. arcs[offsets[u + 1] - 1], sorted by target (roads between the
+// same two vertices stay in input order).
+// If the vertices were renumbered, label[u] is the input number of vertex u and
+// position[id] the vertex with input number id; both are empty otherwise.
+struct CsrGraph {
+    vector<int> offsets;
+    vector<Arc> arcs;
+    vector<int> label, position;
+    int maxWeight = 0;  // Upper bound on the travel times
+    int zeroArcs = 0;   // Arcs with travel time 0 (their ties need ParentChooser)
+
+    int vertices() const { return int(offsets.size()) - 1; }
+    int inputId(int u) const { return label.empty() ? u : label[u]; }
+    int vertexOf(int id) const { return position.empty() ? id : position[id]; }
+    size_t bytes() const {
+        return (offsets.size() + label.size() + position.size()) * sizeof(int) + arcs.size() * sizeof(Arc);
+    }
+};
+
+// Function to sort each vertex's arcs by target
+void sortArcs(CsrGraph& g) {
+    for (int u = 0; u < g.vertices(); u++) {
+        stable_sort(g.arcs.begin() + g.offsets[u], g.arcs.begin() + g.offsets[u + 1],
+                    [](const Arc& a, const Arc& b) { return a.to < b.to; });
+    }
+}
+
+// Function to build the CSR graph of an undirected road list
+// Parameters:
+// - V: Number of vertices
+// - roads: Roads in input order (each becomes an arc in both directions)
+CsrGraph buildCsr(int V, const vector<Road>& roads) {
+    CsrGraph g;
+    g.offsets.assign(V + 1, 0);
+    for (const Road& r : roads) {
+        g.offsets[r.u + 1]++;
+        g.offsets[r.v + 1]++;
+    }
+    for (int u = 0; u < V; u++) g.offsets[u + 1] += g.offsets[u];
+
+    g.arcs.resize(g.offsets[V]);
+    vector<int> next(g.offsets.begin(), g.offsets.end() - 1);
+    for (const Road& r : roads) {
+        g.arcs[next[r.u]++] = {r.v, r.w};
+        g.arcs[next[r.v]++] = {r.u, r.w};
+        g.maxWeight = max(g.maxWeight, r.w);
+        if (r.w == 0) g.zeroArcs += 2;
+    }
+    sortArcs(g);
+    return g;
+}
+
+// Function to compute a locality-improving vertex order
+// Parameters:
+// - g: The graph
+// - mode: "bfs" (breadth-first from vertex 0, then each unvisited vertex) or "rcm"
+//         (reverse Cuthill-McKee: breadth-first from a lowest-degree vertex of each
+//         component, visiting neighbours by increasing degree, then reversed)
+// Returns order, where order[i] is the vertex that becomes vertex i.
+vector<int> vertexOrder(const CsrGraph& g, const string& mode) {
+    int V = g.vertices();
+    auto degree = [&](int u) { return g.offsets[u + 1] - g.offsets[u]; };
+    bool rcm = mode == "rcm";
+
+    vector<int> starts(V);
+    for (int u = 0; u < V; u++) starts[u] = u;
+    if (rcm) stable_sort(starts.begin(), starts.end(), [&](int a, int b) { return degree(a) < degree(b); });
+
+    vector<int> order;
+    order.reserve(V);
+    vector<bool> visited(V, false);
+    vector<int> neighbours;
+    for (int start : starts) {
+        if (visited[start]) continue;
+        visited[start] = true;
+        order.push_back(start);
+        // The order vector doubles as the BFS queue
+        for (size_t head = order.size() - 1; head < order.size(); head++) {
+            int u = order[head];
+            neighbours.clear();
+            for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++) {
+                int v = g.arcs[i].to;
+                if (!visited[v]) {
+                    visited[v] = true;
+                    neighbours.push_back(v);
+                }
+            }
+            if (rcm) stable_sort(neighbours.begin(), neighbours.end(), [&](int a, int b) { return degree(a) < degree(b); });
+            order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+    if (rcm) reverse(order.begin(), order.end());
+    return order;
+}
+
+// Function to renumber the vertices of a graph
+// Parameters:
+// - g: The graph
+// - order: order[i] is the vertex of g that becomes vertex i
+CsrGraph reorderGraph(const CsrGraph& g, const vector<int>& order) {
+    int V = g.vertices();
+    vector<int> newId(V);
+    for (int i = 0; i < V; i++) newId[order[i]] = i;
+
+    CsrGraph r;
+    r.offsets.assign(V + 1, 0);
+    r.arcs.reserve(g.arcs.size());
+    r.label.resize(V);
+    r.position.resize(V);
+    r.maxWeight = g.maxWeight;
+    r.zeroArcs = g.zeroArcs;
+    for (int i = 0; i < V; i++) {
+        int u = order[i];
+        for (int a = g.offsets[u]; a < g.offsets[u + 1]; a++) {
+            r.arcs.push_back({newId[g.arcs[a].to], g.arcs[a].weight});
+        }
+        r.offsets[i + 1] = r.arcs.size();
+        r.label[i] = g.inputId(u);
+        r.position[r.label[i]] = i;
+    }
+    sortArcs(r);
+    return r;
+}
+
+// Operation counts of a Dijkstra run's priority queue
+struct QueueStats {
+    size_t pushes = 0;     // Entries inserted
+    size_t decreases = 0;  // Keys lowered in place (indexed heap only)
+    size_t pops = 0;       // Entries removed
+    size_t stale = 0;      // Removed entries that were outdated (lazy deletion)
+};
+
+// Priority queue implementations. Each is built for a graph's vertex count and largest
+// travel time, and offers push(key, vertex), pop() -> {key, vertex} and empty().
+enum class QueueKind { Auto, Binary, Radix, Dial, FourAry };
+
+// The original binary heap; a vertex is pushed again whenever its distance improves
+class BinaryQueue {
+public:
+    BinaryQueue(int, int) {}
+    void push(int key, int v) { stats.pushes++; pq.push({key, v}); }
+    iPair pop() { stats.pops++; iPair top = pq.top(); pq.pop(); return top; }
+    bool empty() const { return pq.empty(); }
+    QueueStats stats;
+private:
+    priority_queue<iPair, vector<iPair>, greater<iPair>> pq;
+};
+
+// Radix heap: entries are kept in buckets by the highest bit in which their key differs
+// from the last key popped. Popping refills bucket 0 from the lowest non-empty bucket,
+// so each entry moves down at most 32 times. Keys must not drop below the last pop,
+// which Dijkstra guarantees.
+class RadixHeap {
+public:
+    RadixHeap(int, int) {}
+    void push(int key, int v) {
+        stats.pushes++;
+        buckets[bucketOf(key)].push_back({key, v});
+        count++;
+    }
+    iPair pop() {
+        stats.pops++;
+        if (buckets[0].empty()) {
+            int i = 1;
+            while (buckets[i].empty()) i++;
+            last = min_element(buckets[i].begin(), buckets[i].end())->first;
+            for (const iPair& entry : buckets[i]) buckets[bucketOf(entry.first)].push_back(entry);
+            buckets[i].clear();
+        }
+        iPair top = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        return top;
+    }
+    bool empty() const { return count == 0; }
+    QueueStats stats;
+private:
+    int bucketOf(int key) const {
+        unsigned diff = unsigned(key) ^ unsigned(last);
+        return diff == 0 ? 0 : 32 - __builtin_clz(diff);
+    }
+    vector<iPair> buckets[33];
+    int last = 0;
+    size_t count = 0;
+};
+
+// Dial's bucket queue: every key in the queue lies within [current, current + maxWeight],
+// so maxWeight + 1 buckets indexed by key modulo their number suffice
+class DialQueue {
+public:
+    DialQueue(int, int maxWeight) : buckets(maxWeight + 1) {}
+    void push(int key, int v) {
+        stats.pushes++;
+        buckets[key % buckets.size()].push_back(v);
+        count++;
+    }
+    iPair pop() {
+        stats.pops++;
+        while (buckets[current % buckets.size()].empty()) current++;
+        vector<int>& bucket = buckets[current % buckets.size()];
+        int v = bucket.back();
+        bucket.pop_back();
+        count--;
+        return {current, v};
+    }
+    bool empty() const { return count == 0; }
+    QueueStats stats;
+private:
+    vector<vector<int>> buckets;
+    int current = 0;
+    size_t count = 0;
+};
+
+// Indexed 4-ary min-heap: each vertex is in the heap at most once and pushing a vertex
+// that is already there lowers its key in place, so nothing is ever stale
+class FourAryHeap {
+public:
+    FourAryHeap(int V, int) : key(V), slot(V, -1) {}
+    void push(int k, int v) {
+        if (slot[v] == -1) {
+            stats.pushes++;
+            slot[v] = heap.size();
+            heap.push_back(v);
+        } else if (k < key[v]) {
+            stats.decreases++;
+        } else {
+            return;
+        }
+        key[v] = k;
+        siftUp(slot[v]);
+    }
+    iPair pop() {
+        stats.pops++;
+        int top = heap[0];
+        slot[top] = -1;
+        int last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            slot[last] = 0;
+            siftDown(0);
+        }
+        return {key[top], top};
+    }
+    bool empty() const { return heap.empty(); }
+    QueueStats stats;
+private:
+    bool less(int a, int b) const { return key[a] < key[b] || (key[a] == key[b] && a < b); }
+    void place(int i, int v) { heap[i] = v; slot[v] = i; }
+    void siftUp(int i) {
+        int v = heap[i];
+        while (i > 0 && less(v, heap[(i - 1) / 4])) {
+            place(i, heap[(i - 1) / 4]);
+            i = (i - 1) / 4;
+        }
+        place(i, v);
+    }
+    void siftDown(int i) {
+        int v = heap[i], n = heap.size();
+        while (4 * i + 1 < n) {
+            int best = 4 * i + 1;
+            for (int c = best + 1; c < min(4 * i + 5, n); c++) {
+                if (less(heap[c], heap[best])) best = c;
+            }
+            if (!less(heap[best], v)) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, v);
+    }
+    vector<int> heap;        // Vertices in heap order
+    vector<int> key, slot;   // Per vertex: key and position in heap (-1 if absent)
+};
+
+// Function to pick a queue for a graph: Dial's buckets for small travel times, else radix
+QueueKind chooseQueue(const CsrGraph& g, QueueKind kind) {
+    if (kind != QueueKind::Auto) return kind;
+    return g.maxWeight <= DIAL_MAX_WEIGHT ? QueueKind::Dial : QueueKind::Radix;
+}
+
+// Function to name a queue kind (as accepted by --queue=)
+string queueName(QueueKind kind) {
+    switch (kind) {
+        case QueueKind::Binary: return "binary";
+        case QueueKind::Radix: return "radix";
+        case QueueKind::Dial: return "dial";
+        case QueueKind::FourAry: return "4ary";
+        default: return "auto";
+    }
+}
+
+// Function to run Dijkstra's search in a CSR graph, in the graph's own numbering
+// Parameters:
+// - src: Source vertex
+// - g: The graph
+// - dist, parent: Must hold INT_MAX and -1 for every vertex on entry
+// - touched: If not null, receives every vertex given a distance (to reset them later)
+// - settle: Called as settle(u, d) when u is settled at distance d; returning true
+//           ends the search (vertices not yet settled keep tentative values)
+// Ties between equally short paths are resolved as the adjacency-list dijkstra()
+// resolves them on the input numbering: the parent is the tight predecessor with the
+// smallest (distance, input number). The binary heap on the input numbering finds
+// that one first; with renumbering or another queue, a later tight predecessor with
+// the same distance and a smaller input number takes over. Only predecessors across
+// a road of positive travel time take over: they are settled before the vertex, so no
+// vertex becomes the parent of its own ancestor. Over 0-minute roads the parents are
+// a valid tree but not necessarily the dijkstra() ones; ParentChooser fixes them.
+template <typename Queue, typename Settle>
+QueueStats searchCsr(int src, const CsrGraph& g, vector<int>& dist, vector<int>& parent,
+                     vector<int>* touched, Settle settle) {
+    Queue pq(g.vertices(), g.maxWeight);
+    dist[src] = 0;
+    pq.push(0, src);
+    if (touched) touched->push_back(src);
+
+    while (!pq.empty()) {
+        iPair top = pq.pop();
+        int d = top.first, u = top.second;
+        if (d > dist[u]) {
+            pq.stats.stale++;
+            continue;
+        }
+        if (settle(u, d)) break;
+
+        for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++) {
+            int v = g.arcs[i].to;
+            int nd = d + g.arcs[i].weight;
+            if (dist[v] > nd) {
+                if (touched && dist[v] == INT_MAX) touched->push_back(v);
+                dist[v] = nd;
+                parent[v] = u;
+                pq.push(nd, v);
+            } else if (dist[v] == nd && nd > d && parent[v] != -1 && dist[parent[v]] == d &&
+                       g.inputId(u) < g.inputId(parent[v])) {
+                parent[v] = u;
+            }
+        }
+    }
+    return pq.stats;
+}
+
+// Parents over 0-minute roads. A 0-minute road joins two vertices at the same
+// distance, and which of them the adjacency-list dijkstra() settles first, and so
+// which becomes the other's parent, depends on the order it settles that whole
+// distance. choose() replays that order after a search, one distance at a time: each
+// vertex with a tight predecessor at a smaller distance takes the one settled first;
+// then the vertices at the distance are settled smallest input number first, each
+// offering itself across its 0-minute roads to those not settled yet. A parent is
+// always settled before its child, so the parents form a tree. Settle places only
+// matter between vertices at the same distance, so a single-source search whose
+// distances changed at a few places can redo just those distances (rechooseLevel())
+// and the vertices with a tight predecessor there (reconsider()).
+// With several sources (each given a rank), a vertex prefers the smallest source rank
+// among its tight predecessors before the one settled first, and ranks spread along
+// 0-minute roads first; the hospital table uses this to name the first listed of
+// equally near hospitals.
+class ParentChooser {
+public:
+    explicit ParentChooser(int V) : origin(V, INT_MAX), position(V, -1) {}
+
+    // Function to choose the parents of a finished search
+    // Parameters:
+    // - g: The graph
+    // - order: Settled vertices in nondecreasing distance, including every vertex at
+    //          a distance up to the last one's
+    // - dist: Final distances of the vertices in order
+    // - sources: (vertex, rank) of each source
+    // - parent: Receives the parent of each vertex in order (-1 at a source)
+    void choose(const CsrGraph& g, const vector<int>& order, const vector<int>& dist,
+                const vector<iPair>& sources, vector<int>& parent) {
+        for (int u : chosen) {
+            origin[u] = INT_MAX;
+            position[u] = -1;
+        }
+        chosen = order;
+        for (int u : order) parent[u] = -1;
+        for (iPair s : sources) origin[s.first] = min(origin[s.first], s.second);
+        for (size_t first = 0, last = 0; first < order.size(); first = last) {
+            int d = dist[order[first]];
+            while (last < order.size() && dist[order[last]] == d) last++;
+            settleLevel(g, order.begin() + first, order.begin() + last, dist, parent);
+        }
+    }
+
+    // Function to choose again the parents of every vertex at one distance of a
+    // single-source search, after those at smaller distances
+    void rechooseLevel(const CsrGraph& g, const vector<int>& level, int source, const vector<int>& dist,
+                       vector<int>& parent) {
+        for (int v : level) {
+            origin[v] = v == source ? 0 : INT_MAX;
+            position[v] = -1;
+            parent[v] = -1;
+        }
+        settleLevel(g, level.begin(), level.end(), dist, parent);
+    }
+
+    // Function to choose again the parent of a vertex whose distance and settle place
+    // stay, among tight predecessors across roads of positive travel time
+    void reconsider(const CsrGraph& g, int v, const vector<int>& dist, vector<int>& parent) {
+        if (parent[v] == -1 || dist[parent[v]] == dist[v]) return;  // A source, or reached over a 0-minute road
+        for (int i = g.offsets[v]; i < g.offsets[v + 1]; i++) {
+            int u = g.arcs[i].to, w = g.arcs[i].weight;
+            if (w > 0 && position[u] != -1 && dist[u] == dist[v] - w && better(v, origin[u], u, dist, parent)) parent[v] = u;
+        }
+    }
+
+    // Function to give the smallest source rank a vertex of the last choose() reached
+    int rankOf(int u) const { return origin[u]; }
+
+private:
+    vector<int> origin;     // Per vertex: source rank it takes (INT_MAX if none yet)
+    vector<int> position;   // Per vertex: place in the replayed settle order at its distance (-1 if not yet)
+    vector<int> chosen;     // Vertices of the last choose() (to reset them)
+    priority_queue<iPair, vector<iPair>, greater<iPair>> level;  // (rank, input number) at one distance
+
+    // Function to tell whether parent u with rank o beats the current parent of v:
+    // smaller rank first, then settled first (smaller distance, then earlier at it)
+    bool better(int v, int o, int u, const vector<int>& dist, const vector<int>& parent) const {
+        if (o != origin[v]) return o < origin[v];
+        int p = parent[v];
+        return p != -1 && (dist[u] < dist[p] || (dist[u] == dist[p] && position[u] < position[p]));
+    }
+
+    // Function to replay the settling of the vertices at one distance
+    template <typename It>
+    void settleLevel(const CsrGraph& g, It first, It last, const vector<int>& dist, vector<int>& parent) {
+        for (It it = first; it != last; ++it) {
+            int v = *it, d = dist[v];
+            for (int i = g.offsets[v]; i < g.offsets[v + 1]; i++) {
+                int u = g.arcs[i].to, w = g.arcs[i].weight;
+                if (w > 0 && position[u] != -1 && dist[u] == d - w && better(v, origin[u], u, dist, parent)) {
+                    parent[v] = u;
+                    origin[v] = origin[u];
+                }
+            }
+            if (origin[v] != INT_MAX) level.push({origin[v], g.inputId(v)});
+        }
+        int settled = 0;
+        while (!level.empty()) {
+            iPair top = level.top();
+            level.pop();
+            int u = g.vertexOf(top.second);
+            if (position[u] != -1 || top.first != origin[u]) continue;
+            position[u] = settled++;
+            for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++) {
+                int v = g.arcs[i].to;
+                if (g.arcs[i].weight == 0 && position[v] == -1 && better(v, origin[u], u, dist, parent)) {
+                    parent[v] = u;
+                    origin[v] = origin[u];
+                    level.push({origin[v], g.inputId(v)});
+                }
+            }
+        }
+    }
+};
+
+// Function to compute shortest paths to every vertex, in the graph's own numbering
+template <typename Queue>
+QueueStats dijkstraCsr(int src, const CsrGraph& g, vector<int>& dist, vector<int>& parent) {
+    dist.assign(g.vertices(), INT_MAX);
+    parent.assign(g.vertices(), -1);
+    if (g.zeroArcs == 0) return searchCsr<Queue>(src, g, dist, parent, nullptr, [](int, int) { return false; });
+    vector<int> order;
+    QueueStats stats = searchCsr<Queue>(src, g, dist, parent, nullptr, [&](int u, int) {
+        order.push_back(u);
+        return false;
+    });
+    ParentChooser(g.vertices()).choose(g, order, dist, {{src, 0}}, parent);
+    return stats;
+}
+
+// Type carrier for passing a queue type to a generic lambda
+template <typename Queue>
+struct QueueTag {
+    using type = Queue;
+};
+
+// Function to call run(QueueTag<Queue>()) with the queue type selected by kind
+template <typename Run>
+QueueStats withQueue(QueueKind kind, const CsrGraph& g, Run run) {
+    switch (chooseQueue(g, kind)) {
+        case QueueKind::Binary: return run(QueueTag<BinaryQueue>());
+        case QueueKind::Dial: return run(QueueTag<DialQueue>());
+        case QueueKind::FourAry: return run(QueueTag<FourAryHeap>());
+        default: return run(QueueTag<RadixHeap>());
+    }
+}
+
+// Function to run dijkstraCsr() with the requested queue
+QueueStats dijkstraWith(QueueKind kind, int src, const CsrGraph& g, vector<int>& dist, vector<int>& parent) {
+    return withQueue(kind, g, [&](auto tag) {
+        return dijkstraCsr<typename decltype(tag)::type>(src, g, dist, parent);
+    });
+}
+
+// Function to compute shortest paths from source on a CSR graph
+// Parameters and results are in input numbering, as for the adjacency-list version.
+// - kind: Priority queue to use
+// Returns the queue's operation counts.
+QueueStats dijkstra(int src, const CsrGraph& g, vector<int>& dist, vector<int>& parent,
+                    QueueKind kind = QueueKind::Auto) {
+    if (g.label.empty()) return dijkstraWith(kind, src, g, dist, parent);
+    vector<int> d, p;
+    QueueStats stats = dijkstraWith(kind, g.vertexOf(src), g, d, p);
+    int V = g.vertices();
+    dist.resize(V);
+    parent.resize(V);
+    for (int u = 0; u < V; u++) {
+        dist[g.label[u]] = d[u];
+        parent[g.label[u]] = p[u] == -1 ? -1 : g.label[p[u]];
+    }
+    return stats;
+}
+
+// Nearest hospital from one start location
+struct Dispatch {
+    int hospital = -1;  // Input number of the hospital (-1 if none is reachable)
+    int time = INT_MAX; // Travel time to it
+    vector<int> path;   // Intersections from the start to the hospital (input numbering)
+};
+
+// Nearest-hospital search that stops once the nearest hospital is settled. Distances
+// and parents live in arrays kept between queries; only the entries a query touched
+// are reset afterwards, so a nearby hospital costs time for the vertices searched,
+// not for the whole graph. The answer (hospital, time and path) is the one the full
+// search plus scan gives: among equally near hospitals the first listed wins, so the
+// search runs on until every vertex at the nearest hospital's distance is settled.
+// With 0-minute roads the settled vertices then get their parents from ParentChooser.
+class HospitalFinder {
+public:
+    // Parameters:
+    // - g: The graph (must outlive the finder)
+    // - hospitals: Hospital intersections (input numbering), in list order
+    // - kind: Priority queue to use
+    HospitalFinder(const CsrGraph& g, const vector<int>& hospitals, QueueKind kind)
+        : g(g), kind(kind), rank(g.vertices(), -1), dist(g.vertices(), INT_MAX), parent(g.vertices(), -1),
+          chooser(g.vertices()) {
+        for (int i = int(hospitals.size()) - 1; i >= 0; i--) rank[g.vertexOf(hospitals[i])] = i;
+    }
+
+    // Function to find the nearest hospital from source (input numbering)
+    Dispatch find(int source) {
+        int best = -1, bestTime = INT_MAX;
+        auto settle = [&](int u, int d) {
+            if (best != -1 && d > bestTime) return true;
+            if (rank[u] != -1 && (best == -1 || rank[u] < rank[best])) {
+                best = u;
+                bestTime = d;
+            }
+            if (g.zeroArcs > 0) order.push_back(u);
+            return false;
+        };
+        stats = withQueue(kind, g, [&](auto tag) {
+            return searchCsr<typename decltype(tag)::type>(g.vertexOf(source), g, dist, parent, &touched, settle);
+        });
+        if (g.zeroArcs > 0) {
+            chooser.choose(g, order, dist, {{g.vertexOf(source), 0}}, parent);
+            order.clear();
+        }
+
+        Dispatch result;
+        if (best != -1) {
+            result.hospital = g.inputId(best);
+            result.time = bestTime;
+            for (int u = best; u != -1; u = parent[u]) result.path.push_back(g.inputId(u));
+            reverse(result.path.begin(), result.path.end());
+        }
+        for (int u : touched) {
+            dist[u] = INT_MAX;
+            parent[u] = -1;
+        }
+        settled = touched.size();
+        touched.clear();
+        return result;
+    }
+
+    QueueStats stats;   // Queue counts of the last search
+    size_t settled = 0; // Vertices reached by the last search
+
+private:
+    const CsrGraph& g;
+    QueueKind kind;
+    vector<int> rank;           // Position in the hospital list (-1 if not a hospital)
+    vector<int> dist, parent;   // Search state (INT_MAX / -1 outside a search)
+    vector<int> touched;        // Vertices given a distance in the current search
+    vector<int> order;          // Vertices settled (only with 0-minute roads)
+    ParentChooser chooser;
+};
+
+// Entry of the nearest-hospital table
+struct HospitalRoute {
+    int hospital = -1;  // Nearest hospital (-1 if none is reachable)
+    int time = INT_MAX; // Travel time to it
+    int next = -1;      // Next intersection on the way there (-1 at the hospital)
+};
+
+// Function to compute the nearest hospital of every intersection with a single
+// Dijkstra search started from all hospitals at once (roads are two-way, so the
+// distance from a hospital is the distance to it). A vertex inherits the hospital of
+// its parent; between equally near hospitals the first listed wins, as in the full
+// search, so the table gives the same hospital and time. The search settles that
+// tie as it goes, through a later tight predecessor taking over as in searchCsr();
+// with 0-minute roads ParentChooser settles it afterwards, ranking the hospitals by
+// list position. The route is a shortest one but may differ from the full search's
+// path when several are equally short.
+// Parameters:
+// - g: The graph
+// - hospitals: Hospital intersections (input numbering), in list order
+// - kind: Priority queue to use
+// - stats: Receives the queue's operation counts
+// Returns the table indexed by input number.
+vector<HospitalRoute> hospitalTable(const CsrGraph& g, const vector<int>& hospitals, QueueKind kind,
+                                    QueueStats& stats) {
+    int V = g.vertices();
+    vector<int> dist(V, INT_MAX), parent(V, -1), origin(V, INT_MAX), order;
+    vector<iPair> sources;
+    for (int i = 0; i < int(hospitals.size()); i++) {
+        int u = g.vertexOf(hospitals[i]);
+        sources.push_back({u, i});
+        origin[u] = min(origin[u], i);
+    }
+
+    stats = withQueue(kind, g, [&](auto tag) {
+        typename decltype(tag)::type pq(V, g.maxWeight);
+        for (iPair s : sources) {
+            int u = s.first;
+            if (dist[u] == 0) continue;
+            dist[u] = 0;
+            pq.push(0, u);
+        }
+        while (!pq.empty()) {
+            iPair top = pq.pop();
+            int d = top.first, u = top.second;
+            if (d > dist[u]) {
+                pq.stats.stale++;
+                continue;
+            }
+            order.push_back(u);
+            for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++) {
+                int v = g.arcs[i].to;
+                int nd = d + g.arcs[i].weight;
+                if (dist[v] > nd) {
+                    dist[v] = nd;
+                    parent[v] = u;
+                    origin[v] = origin[u];
+                    pq.push(nd, v);
+                } else if (dist[v] == nd && nd > d && parent[v] != -1 && origin[u] < origin[v]) {
+                    parent[v] = u;
+                    origin[v] = origin[u];
+                }
+            }
+        }
+        return pq.stats;
+    });
+    if (g.zeroArcs > 0) {
+        ParentChooser chooser(V);
+        chooser.choose(g, order, dist, sources, parent);
+        for (int u : order) origin[u] = chooser.rankOf(u);
+    }
+
+    vector<HospitalRoute> table(V);
+    for (int u : order) {
+        HospitalRoute& route = table[g.inputId(u)];
+        route.hospital = hospitals[origin[u]];
+        route.time = dist[u];
+        route.next = parent[u] == -1 ? -1 : g.inputId(parent[u]);
+    }
+    return table;
+}
+
+// Function to dispatch from the nearest-hospital table by following next hops
+Dispatch dispatchFromTable(const vector<HospitalRoute>& table, int source) {
+    Dispatch result;
+    if (table[source].hospital == -1) return result;
+    result.hospital = table[source].hospital;
+    result.time = table[source].time;
+    for (int u = source; u != -1; u = table[u].next) result.path.push_back(u);
+    return result;
+}
+
+// Function to find the arcs from a to b (graph numbering) by binary search
+// Returns the index range [first, last) in g.arcs (empty if there is no such road).
+iPair arcRange(const CsrGraph& g, int a, int b) {
+    auto first = g.arcs.begin() + g.offsets[a], last = g.arcs.begin() + g.offsets[a + 1];
+    auto range = equal_range(first, last, Arc{b, 0}, [](const Arc& x, const Arc& y) { return x.to < y.to; });
+    return {int(range.first - g.arcs.begin()), int(range.second - g.arcs.begin())};
+}
+
+// Function to change the travel time of every road between u and v (input numbering)
+void setTravelTime(CsrGraph& g, int u, int v, int w) {
+    int a = g.vertexOf(u), b = g.vertexOf(v);
+    g.maxWeight = max(g.maxWeight, w);
+    for (iPair range : {arcRange(g, a, b), arcRange(g, b, a)}) {
+        for (int i = range.first; i < range.second; i++) {
+            g.zeroArcs += (w == 0) - (g.arcs[i].weight == 0);
+            g.arcs[i].weight = w;
+        }
+    }
+}
+
+// Shortest paths from one source, kept up to date as travel times change.
+// update() applies a batch of road changes and repairs the distances:
+// - A road that got slower only matters if it is a tree edge; every vertex in the
+//   subtree below it loses its distance and restarts from its best neighbour outside
+//   the subtree.
+// - A road that got faster offers its far end a shorter distance.
+// - Those vertices seed a Dijkstra pass that spreads the changes and stops where
+//   distances no longer move.
+// The result, parents included, equals a fresh dijkstra() after the same changes.
+// Parents use the same rule (smallest distance, then smallest input number among the
+// tight neighbours), checked against the neighbour's current distance because the
+// repair does not settle vertices in global distance order. Only a neighbour across a
+// road of positive travel time can take over, so a vertex never adopts one of its own
+// descendants. While the graph has 0-minute roads the tree's vertices are also kept by
+// distance, and ParentChooser redoes the parents only at the distances the repair
+// touched (those of the vertices it changed, before and after, of their neighbours and
+// of the changed roads' ends) and of the vertices with a tight predecessor there.
+// A batch whose repair would settle more than 1/REPAIR_FRACTION of the vertices, or
+// redo the ties of that many, recomputes the tree from the source instead.
+// Seeds carry arbitrary distances, so the repair uses the radix heap (Dial's buckets
+// assume a narrow range).
+class DynamicPaths {
+public:
+    // Parameters:
+    // - g: The graph (updated through this object; must outlive it)
+    // - source: Source vertex (input numbering)
+    DynamicPaths(CsrGraph& g, int source)
+        : g(g), source(g.vertexOf(source)), affected(g.vertices(), false), previous(g.vertices(), -1),
+          chooser(g.vertices()) {
+        recompute();
+    }
+
+    // Function to change travel times (input numbering, as in setTravelTime) and repair
+    void update(const vector<Road>& changes) {
+        bool zeroRoads = g.zeroArcs > 0;
+        int limit = g.vertices() / REPAIR_FRACTION;
+        vector<int> roots;              // Vertices below a slower tree edge
+        vector<iPair> faster;           // Arcs (from, to) that got faster
+        vector<int> roadEnds;           // Ends of the changed roads
+        for (const Road& r : changes) {
+            int a = g.vertexOf(r.u), b = g.vertexOf(r.v);
+            g.maxWeight = max(g.maxWeight, r.w);
+            for (iPair ends : {iPair{a, b}, iPair{b, a}}) {
+                iPair range = arcRange(g, ends.first, ends.second);
+                for (int i = range.first; i < range.second; i++) {
+                    int old = g.arcs[i].weight;
+                    g.zeroArcs += (r.w == 0) - (old == 0);
+                    g.arcs[i].weight = r.w;
+                    if (r.w > old && parent[ends.second] == ends.first) roots.push_back(ends.second);
+                    if (r.w < old) faster.push_back(ends);
+                }
+            }
+            roadEnds.push_back(a);
+            roadEnds.push_back(b);
+        }
+
+        // Collect the subtrees below slower tree edges and forget their distances
+        vector<int> subtree;
+        for (int root : roots) {
+            if (affected[root]) continue;
+            affected[root] = true;
+            subtree.push_back(root);
+        }
+        for (size_t head = 0; head < subtree.size() && int(subtree.size()) <= limit; head++) {
+            int u = subtree[head];
+            for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++) {
+                int v = g.arcs[i].to;
+                if (!affected[v] && parent[v] == u) {
+                    affected[v] = true;
+                    subtree.push_back(v);
+                }
+            }
+        }
+        if (int(subtree.size()) > limit) {
+            for (int u : subtree) affected[u] = false;
+            recompute();
+            return;
+        }
+        for (int u : subtree) {
+            note(u);
+            dist[u] = INT_MAX;
+            parent[u] = -1;
+        }
+
+        RadixHeap pq(g.vertices(), g.maxWeight);
+        // Restart each affected vertex from its neighbours outside the subtree
+        for (int v : subtree) {
+            for (int i = g.offsets[v]; i < g.offsets[v + 1]; i++) {
+                int u = g.arcs[i].to;
+                if (!affected[u] && dist[u] != INT_MAX) offer(u, v, dist[u] + g.arcs[i].weight, pq);
+            }
+        }
+        for (int v : subtree) affected[v] = false;
+        // Offer the far ends of faster roads a shorter distance
+        for (iPair arc : faster) {
+            int u = arc.first, v = arc.second;
+            if (dist[u] == INT_MAX) continue;
+            iPair range = arcRange(g, u, v);
+            for (int i = range.first; i < range.second; i++) offer(u, v, dist[u] + g.arcs[i].weight, pq);
+        }
+
+        // Spread the changes
+        repaired = 0;
+        while (!pq.empty()) {
+            iPair top = pq.pop();
+            int d = top.first, u = top.second;
+            if (d > dist[u]) continue;
+            if (int(++repaired) > limit) {
+                recompute();
+                return;
+            }
+            for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++) offer(u, g.arcs[i].to, d + g.arcs[i].weight, pq);
+        }
+
+        // Settle ties over 0-minute roads (also the ones the batch just removed)
+        if (zeroRoads || g.zeroArcs > 0) settleTies(roadEnds, limit);
+        if (g.zeroArcs == 0) levels.clear();
+        for (int v : changed) previous[v] = -1;
+        changed.clear();
+    }
+
+    int distance(int id) const { return dist[g.vertexOf(id)]; }
+    int parentOf(int id) const {
+        int p = parent[g.vertexOf(id)];
+        return p == -1 ? -1 : g.inputId(p);
+    }
+
+    size_t repaired = 0;  // Vertices settled by the last repair (or recomputation)
+
+private:
+    // Function to offer v the distance nd through u, keeping the parent rule
+    void offer(int u, int v, int nd, RadixHeap& pq) {
+        if (v == source) return;
+        if (nd < dist[v]) {
+            note(v);
+            dist[v] = nd;
+            parent[v] = u;
+            pq.push(nd, v);
+        } else if (nd == dist[v] && dist[u] < nd && parent[v] != u &&
+                   (dist[u] < dist[parent[v]] || (dist[u] == dist[parent[v]] && g.inputId(u) < g.inputId(parent[v])))) {
+            note(v);
+            parent[v] = u;
+        }
+    }
+
+    // Function to remember v's distance before the repair first changes it or its parent
+    void note(int v) {
+        if (previous[v] != -1) return;
+        previous[v] = dist[v];
+        changed.push_back(v);
+    }
+
+    // Function to compute the tree from the source (with the queue dijkstra() picks)
+    void recompute() {
+        for (int v : changed) previous[v] = -1;
+        changed.clear();
+        dist.assign(g.vertices(), INT_MAX);
+        parent.assign(g.vertices(), -1);
+        vector<int> order;
+        withQueue(QueueKind::Auto, g, [&](auto tag) {
+            return searchCsr<typename decltype(tag)::type>(source, g, dist, parent, nullptr, [&](int u, int) {
+                order.push_back(u);
+                return false;
+            });
+        });
+        levels.clear();
+        if (g.zeroArcs > 0) {
+            chooser.choose(g, order, dist, {{source, 0}}, parent);
+            auto level = levels.end();
+            for (int u : order) {
+                if (level == levels.end() || level->first != dist[u]) level = levels.emplace_hint(levels.end(), dist[u], vector<int>());
+                level->second.push_back(u);
+            }
+        }
+        repaired = order.size();
+    }
+
+    // Function to redo the parents over 0-minute roads where the repair may have moved them
+    // Parameters:
+    // - ends: Ends of the changed roads
+    // - limit: Most vertices to redo before redoing all of them
+    void settleTies(const vector<int>& ends, int limit) {
+        if (levels.empty()) {
+            // The graph just got its first 0-minute roads
+            for (int u = 0; u < g.vertices(); u++) {
+                if (dist[u] != INT_MAX) levels[dist[u]].push_back(u);
+            }
+            chooseAll();
+            return;
+        }
+        for (int v : changed) {
+            if (previous[v] == dist[v]) continue;
+            vector<int>& from = levels[previous[v]];
+            *find(from.begin(), from.end(), v) = from.back();
+            from.pop_back();
+            if (from.empty()) levels.erase(previous[v]);
+            levels[dist[v]].push_back(v);
+        }
+
+        vector<int> dirty;
+        for (int v : changed) {
+            dirty.push_back(previous[v]);
+            dirty.push_back(dist[v]);
+            for (int i = g.offsets[v]; i < g.offsets[v + 1]; i++) dirty.push_back(dist[g.arcs[i].to]);
+        }
+        for (int v : ends) dirty.push_back(dist[v]);
+        sort(dirty.begin(), dirty.end());
+        dirty.erase(unique(dirty.begin(), dirty.end()), dirty.end());
+        vector<const vector<int>*> redo;
+        int count = 0;
+        for (int d : dirty) {
+            auto level = levels.find(d);
+            if (level == levels.end()) continue;
+            redo.push_back(&level->second);
+            count += level->second.size();
+        }
+        if (count > limit) {
+            chooseAll();
+            return;
+        }
+
+        for (const vector<int>* level : redo) chooser.rechooseLevel(g, *level, source, dist, parent);
+        for (const vector<int>* level : redo) {
+            for (int u : *level) {
+                for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++) {
+                    int v = g.arcs[i].to;
+                    if (!binary_search(dirty.begin(), dirty.end(), dist[v])) chooser.reconsider(g, v, dist, parent);
+                }
+            }
+        }
+    }
+
+    // Function to redo the parents of every reached vertex
+    void chooseAll() {
+        vector<int> order;
+        for (const auto& level : levels) order.insert(order.end(), level.second.begin(), level.second.end());
+        chooser.choose(g, order, dist, {{source, 0}}, parent);
+    }
+
+    CsrGraph& g;
+    int source;
+    vector<int> dist, parent;   // Graph numbering
+    vector<bool> affected;      // Marks the current subtree (false outside update())
+    vector<int> previous;       // Per vertex: distance before the current update (-1 if unchanged)
+    vector<int> changed;        // Vertices with a previous distance
+    map<int, vector<int>> levels;  // Reached vertices by distance (while there are 0-minute roads)
+    ParentChooser chooser;
+};
+
+// Edge of a contraction hierarchy: a road, or a shortcut for the two edges through
+// a contracted vertex
+struct ChArc {
+    int to;      // Higher-ranked end
+    int weight;  // Travel time
+    int middle;  // Vertex the shortcut bypasses (-1 for a road)
+};
+
+// Contraction hierarchy in input numbering. Each edge is stored once, at its
+// lower-ranked end (arcs[offsets[u]] .. arcs[offsets[u + 1] - 1], sorted by target),
+// since a query only ever follows edges upwards.
+struct ContractionHierarchy {
+    vector<int> rank;       // Contraction order of each vertex
+    vector<int> offsets;
+    vector<ChArc> arcs;
+
+    int vertices() const { return rank.size(); }
+    size_t bytes() const { return (rank.size() + offsets.size()) * sizeof(int) + arcs.size() * sizeof(ChArc); }
+};
+
+// Header at the start of a hierarchy file, followed by rank (vertices int32 values),
+// offsets (vertices + 1 int32 values) and arcs (packed ChArc records)
+struct ChFileHeader {
+    char magic[4];         // Always "CHIX"
+    uint32_t version;      // Format version (CH_FILE_VERSION)
+    uint32_t vertices;     // Number of vertices
+    uint32_t arcs;         // Number of arcs
+    uint64_t fingerprint;  // graphFingerprint() of the roads it was built from
+    uint64_t reserved;
+};
+
+// Current hierarchy file format version
+const uint32_t CH_FILE_VERSION = 1;
+
+// Function to hash a graph's roads independently of numbering and arc order, so a
+// saved hierarchy can be matched to the roads it was built from
+uint64_t graphFingerprint(const CsrGraph& g) {
+    uint64_t hash = g.vertices();
+    for (int u = 0; u < g.vertices(); u++) {
+        for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++) {
+            uint64_t x = (uint64_t(g.inputId(u)) << 40) ^ (uint64_t(g.inputId(g.arcs[i].to)) << 16) ^ uint64_t(g.arcs[i].weight);
+            x *= 0x9E3779B97F4A7C15ULL;
+            hash += x ^ (x >> 29);
+        }
+    }
+    return hash;
+}
+
+// Function to build a contraction hierarchy
+// Vertices are contracted in order of 2 * (shortcuts added - remaining roads) +
+// neighbours already contracted + level (one more than the highest level among its
+// contracted neighbours, which keeps the hierarchy shallow), re-evaluated lazily when
+// a vertex reaches the front. Contracting
+// v connects each pair of its remaining neighbours by a shortcut unless a witness
+// search finds a path at most as short that avoids v; a search that gives up after
+// WITNESS_SETTLE_LIMIT vertices adds the shortcut, which costs space but never
+// correctness. The edges v still has when it is contracted become its upward edges.
+// Parameters:
+// - g: The graph
+// - shortcuts: Receives the number of shortcuts added
+ContractionHierarchy buildHierarchy(const CsrGraph& g, size_t& shortcuts) {
+    int V = g.vertices();
+    // Remaining graph, one edge (the fastest) per neighbour
+    vector<vector<ChArc>> adj(V);
+    auto addEdge = [&](int u, int v, int w, int middle) {
+        for (ChArc& e : adj[u]) {
+            if (e.to == v) {
+                if (w < e.weight) e = {v, w, middle};
+                return;
+            }
+        }
+        adj[u].push_back({v, w, middle});
+    };
+    for (int u = 0; u < V; u++) {
+        for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++) {
+            int v = g.arcs[i].to;
+            if (v != u) addEdge(g.inputId(u), g.inputId(v), g.arcs[i].weight, -1);
+        }
+    }
+
+    // Witness search state; the search stops early once every target is settled
+    vector<int> wdist(V, INT_MAX), touched;
+    vector<char> isTarget(V, 0);
+    vector<iPair> heap;
+    auto witness = [&](int from, int skip, int limit, int targets) {
+        heap.clear();
+        wdist[from] = 0;
+        touched.push_back(from);
+        heap.push_back({0, from});
+        int settled = 0;
+        while (!heap.empty() && settled < WITNESS_SETTLE_LIMIT && targets > 0) {
+            pop_heap(heap.begin(), heap.end(), greater<iPair>());
+            int d = heap.back().first, u = heap.back().second;
+            heap.pop_back();
+            if (d > wdist[u]) continue;
+            if (d > limit) break;
+            settled++;
+            targets -= isTarget[u];
+            for (const ChArc& e : adj[u]) {
+                if (e.to == skip || d + e.weight >= wdist[e.to]) continue;
+                if (wdist[e.to] == INT_MAX) touched.push_back(e.to);
+                wdist[e.to] = d + e.weight;
+                heap.push_back({wdist[e.to], e.to});
+                push_heap(heap.begin(), heap.end(), greater<iPair>());
+            }
+        }
+    };
+
+    // Function to find the shortcuts contracting v needs (as {u, x, weight} roads)
+    vector<Road> needed;
+    auto shortcutsFor = [&](int v) {
+        needed.clear();
+        const vector<ChArc>& nb = adj[v];
+        for (size_t i = 0; i + 1 < nb.size(); i++) {
+            int longest = 0;
+            for (size_t j = i + 1; j < nb.size(); j++) {
+                longest = max(longest, nb[j].weight);
+                isTarget[nb[j].to] = 1;
+            }
+            witness(nb[i].to, v, nb[i].weight + longest, nb.size() - i - 1);
+            for (size_t j = i + 1; j < nb.size(); j++) {
+                int via = nb[i].weight + nb[j].weight;
+                if (wdist[nb[j].to] > via) needed.push_back({nb[i].to, nb[j].to, via});
+                isTarget[nb[j].to] = 0;
+            }
+            for (int u : touched) wdist[u] = INT_MAX;
+            touched.clear();
+        }
+    };
+
+    vector<int> deleted(V, 0), level(V, 0);
+    auto priority = [&](int v) {
+        shortcutsFor(v);
+        return 2 * (int(needed.size()) - int(adj[v].size())) + deleted[v] + level[v];
+    };
+    priority_queue<iPair, vector<iPair>, greater<iPair>> order;
+    for (int v = 0; v < V; v++) order.push({priority(v), v});
+
+    ContractionHierarchy ch;
+    ch.rank.assign(V, -1);
+    vector<vector<ChArc>> up(V);
+    shortcuts = 0;
+    int next = 0;
+    while (!order.empty()) {
+        int v = order.top().second;
+        order.pop();
+        if (ch.rank[v] != -1) continue;
+        // Lazy update: contract v only if it is still no worse than the next candidate
+        int p = priority(v);
+        if (!order.empty() && p > order.top().first) {
+            order.push({p, v});
+            continue;
+        }
+
+        ch.rank[v] = next++;
+        up[v] = adj[v];
+        for (const ChArc& e : adj[v]) {
+            vector<ChArc>& back = adj[e.to];
+            back.erase(find_if(back.begin(), back.end(), [&](const ChArc& x) { return x.to == v; }));
+            deleted[e.to]++;
+            level[e.to] = max(level[e.to], level[v] + 1);
+        }
+        for (const Road& r : needed) {
+            addEdge(r.u, r.v, r.w, v);
+            addEdge(r.v, r.u, r.w, v);
+        }
+        shortcuts += needed.size();
+        adj[v].clear();
+        adj[v].shrink_to_fit();
+    }
+
+    ch.offsets.assign(V + 1, 0);
+    for (int v = 0; v < V; v++) {
+        sort(up[v].begin(), up[v].end(), [](const ChArc& a, const ChArc& b) { return a.to < b.to; });
+        ch.arcs.insert(ch.arcs.end(), up[v].begin(), up[v].end());
+        ch.offsets[v + 1] = ch.arcs.size();
+    }
+    return ch;
+}
+
+// Function to save a hierarchy to a binary file
+// Returns false (after printing an error) if the file cannot be written.
+bool saveHierarchy(const ContractionHierarchy& ch, uint64_t fingerprint, const string& path) {
+    ChFileHeader header = {};
+    memcpy(header.magic, "CHIX", 4);
+    header.version = CH_FILE_VERSION;
+    header.vertices = ch.vertices();
+    header.arcs = ch.arcs.size();
+    header.fingerprint = fingerprint;
+    FILE* file = fopen(path.c_str(), "wb");
+    bool ok = file && fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(ch.rank.data(), sizeof(int), ch.rank.size(), file) == ch.rank.size() &&
+              fwrite(ch.offsets.data(), sizeof(int), ch.offsets.size(), file) == ch.offsets.size() &&
+              fwrite(ch.arcs.data(), sizeof(ChArc), ch.arcs.size(), file) == ch.arcs.size();
+    if (file && fclose(file) != 0) ok = false;
+    if (!ok) cout << "Error: Cannot write " << path << "." << endl;
+    return ok;
+}
+
+// Function to check that a loaded hierarchy has the shape buildHierarchy() gives it:
+// offsets ascend within [0, arcs], ranks are a permutation of 0..V-1, each vertex's
+// arcs lead to higher-ranked vertices in ascending order, and every shortcut's middle
+// vertex is ranked below both ends and has the arcs to them. ChRouter relies on all of
+// it: its searches index by arc target, and unpack() looks up the two halves of each
+// shortcut and recurses on them (down in rank, so it ends).
+bool hierarchyConsistent(const ContractionHierarchy& ch) {
+    int V = ch.vertices();
+    int arcs = ch.arcs.size();
+    if (ch.offsets[0] != 0 || ch.offsets[V] != arcs) return false;
+    for (int v = 0; v < V; v++) {
+        if (ch.offsets[v] > ch.offsets[v + 1]) return false;
+    }
+    vector<bool> seen(V, false);
+    for (int r : ch.rank) {
+        if (r < 0 || r >= V || seen[r]) return false;
+        seen[r] = true;
+    }
+    for (int u = 0; u < V; u++) {
+        for (int i = ch.offsets[u]; i < ch.offsets[u + 1]; i++) {
+            const ChArc& e = ch.arcs[i];
+            if (e.to < 0 || e.to >= V || e.middle < -1 || e.middle >= V) return false;
+            if (ch.rank[e.to] <= ch.rank[u] || (i > ch.offsets[u] && ch.arcs[i - 1].to >= e.to)) return false;
+        }
+    }
+    auto hasArc = [&](int low, int high) {
+        auto first = ch.arcs.begin() + ch.offsets[low], last = ch.arcs.begin() + ch.offsets[low + 1];
+        auto e = lower_bound(first, last, high, [](const ChArc& a, int to) { return a.to < to; });
+        return e != last && e->to == high;
+    };
+    for (int u = 0; u < V; u++) {
+        for (int i = ch.offsets[u]; i < ch.offsets[u + 1]; i++) {
+            int middle = ch.arcs[i].middle;
+            if (middle != -1 && (ch.rank[middle] >= ch.rank[u] || !hasArc(middle, u) || !hasArc(middle, ch.arcs[i].to)))
+                return false;
+        }
+    }
+    return true;
+}
+
+// Function to load a hierarchy saved by saveHierarchy() for a graph of V vertices
+// Returns false if the file is missing, malformed or built from other roads.
+bool loadHierarchy(ContractionHierarchy& ch, int V, uint64_t fingerprint, const string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    ChFileHeader header = {};
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, "CHIX", 4) == 0 &&
+              header.version == CH_FILE_VERSION && header.fingerprint == fingerprint &&
+              header.vertices == uint32_t(V) && header.arcs <= uint32_t(numeric_limits<int>::max());
+    if (ok) {
+        // Check the sizes in the header against the file before allocating
+        long start = ftell(file);
+        ok = start >= 0 && fseek(file, 0, SEEK_END) == 0;
+        long end = ok ? ftell(file) : -1;
+        ok = ok && end >= start && fseek(file, start, SEEK_SET) == 0 &&
+             uint64_t(end - start) == (2 * uint64_t(header.vertices) + 1) * sizeof(int) + uint64_t(header.arcs) * sizeof(ChArc);
+    }
+    if (ok) {
+        ch.rank.resize(header.vertices);
+        ch.offsets.resize(header.vertices + 1);
+        ch.arcs.resize(header.arcs);
+        ok = fread(ch.rank.data(), sizeof(int), ch.rank.size(), file) == ch.rank.size() &&
+             fread(ch.offsets.data(), sizeof(int), ch.offsets.size(), file) == ch.offsets.size() &&
+             fread(ch.arcs.data(), sizeof(ChArc), ch.arcs.size(), file) == ch.arcs.size() &&
+             fgetc(file) == EOF && hierarchyConsistent(ch);
+    }
+    fclose(file);
+    return ok;
+}
+
+// Query engine over a contraction hierarchy. The shortest path between s and t climbs
+// in rank to a top vertex and descends again, so a full upward search from s and an
+// upward search from t (pruned once its distance reaches the best meeting found)
+// find it. Shortcuts on the way are unpacked through their middle vertices. Times
+// equal dijkstra()'s; when several routes are equally fast the path may be another one.
+class ChRouter {
+public:
+    explicit ChRouter(const ContractionHierarchy& ch)
+        : ch(ch), forward(ch.vertices()), backward(ch.vertices()), place(ch.vertices(), -1) {}
+
+    // Function to find the travel time and path from source to target (input numbering)
+    Dispatch route(int source, int target) {
+        return nearest(source, {target});
+    }
+
+    // Function to find the nearest of the hospitals from source; among equally near
+    // hospitals the first listed wins, as in the full search
+    Dispatch nearest(int source, const vector<int>& hospitals) {
+        search(forward, source, INT_MAX);
+        Dispatch result;
+        vector<int> down;  // Packed path from the meeting vertex down to the best hospital
+        int meet = -1;
+        for (int h : hospitals) {
+            int best = result.time, bestMeet = -1;
+            search(backward, h, best, &best, &bestMeet);
+            if (bestMeet != -1 && best < result.time) {
+                result.time = best;
+                result.hospital = h;
+                meet = bestMeet;
+                down.clear();
+                for (int u = meet; u != -1; u = backward.parent[u]) down.push_back(u);
+            }
+            backward.reset();
+        }
+
+        if (meet != -1) {
+            vector<int> packed;
+            for (int u = meet; u != -1; u = forward.parent[u]) packed.push_back(u);
+            reverse(packed.begin(), packed.end());
+            packed.insert(packed.end(), down.begin() + 1, down.end());
+            result.path.push_back(packed[0]);
+            for (size_t i = 0; i + 1 < packed.size(); i++) unpack(packed[i], packed[i + 1], result.path);
+
+            // Over 0-minute roads the route can come back to a vertex; cut such loops
+            // (they take no time)
+            vector<int> route;
+            for (int u : result.path) {
+                if (place[u] != -1) {
+                    while (int(route.size()) > place[u] + 1) {
+                        place[route.back()] = -1;
+                        route.pop_back();
+                    }
+                    continue;
+                }
+                place[u] = route.size();
+                route.push_back(u);
+            }
+            for (int u : route) place[u] = -1;
+            result.path = move(route);
+        }
+        forward.reset();
+        return result;
+    }
+
+    size_t searched = 0;  // Vertices settled by the last query (both directions)
+
+private:
+    // Upward search state, reset lazily through touched
+    struct Side {
+        vector<int> dist, parent, touched;
+        explicit Side(int V) : dist(V, INT_MAX), parent(V, -1) {}
+        void reset() {
+            for (int u : touched) {
+                dist[u] = INT_MAX;
+                parent[u] = -1;
+            }
+            touched.clear();
+        }
+    };
+
+    // Function to search upwards from start, stopping at distance bound; if best is
+    // given, meetings with the forward search below *best are recorded
+    void search(Side& side, int start, int bound, int* best = nullptr, int* meet = nullptr) {
+        priority_queue<iPair, vector<iPair>, greater<iPair>> pq;
+        side.dist[start] = 0;
+        side.touched.push_back(start);
+        pq.push({0, start});
+        if (!best) searched = 0;
+        while (!pq.empty()) {
+            int d = pq.top().first, u = pq.top().second;
+            pq.pop();
+            if (d > side.dist[u]) continue;
+            if (best) bound = *best;
+            if (d >= bound) break;
+            searched++;
+            if (best && forward.dist[u] != INT_MAX && (long long)forward.dist[u] + d < *best) {
+                *best = forward.dist[u] + d;
+                *meet = u;
+            }
+            // Stall on demand: if a higher neighbour already offers a shorter way to u,
+            // no shortest path climbs through u from here
+            bool stalled = false;
+            for (int i = ch.offsets[u]; i < ch.offsets[u + 1] && !stalled; i++) {
+                const ChArc& e = ch.arcs[i];
+                stalled = side.dist[e.to] != INT_MAX && side.dist[e.to] + e.weight < d;
+            }
+            if (stalled) continue;
+            for (int i = ch.offsets[u]; i < ch.offsets[u + 1]; i++) {
+                const ChArc& e = ch.arcs[i];
+                if (d + e.weight < side.dist[e.to]) {
+                    if (side.dist[e.to] == INT_MAX) side.touched.push_back(e.to);
+                    side.dist[e.to] = d + e.weight;
+                    side.parent[e.to] = u;
+                    pq.push({side.dist[e.to], e.to});
+                }
+            }
+        }
+    }
+
+    // Function to append the road-level vertices after u on the hierarchy edge u-v
+    void unpack(int u, int v, vector<int>& path) const {
+        int low = ch.rank[u] < ch.rank[v] ? u : v, high = low == u ? v : u;
+        auto first = ch.arcs.begin() + ch.offsets[low], last = ch.arcs.begin() + ch.offsets[low + 1];
+        auto e = lower_bound(first, last, high, [](const ChArc& a, int to) { return a.to < to; });
+        // hierarchyConsistent() rules a missing arc out for loaded files; should one
+        // still be missing, keep the hop as it is rather than read past the arcs
+        if (e == last || e->to != high || e->middle == -1) {
+            path.push_back(v);
+        } else {
+            int middle = e->middle;
+            unpack(u, middle, path);
+            unpack(middle, v, path);
+        }
+    }
+
+    const ContractionHierarchy& ch;
+    Side forward, backward;
+    vector<int> place;  // Per vertex: index in the route being built (-1 outside nearest())
+};
+
+// Function to print a path given as a list of nodes
+void printPath(const vector<int>& path) {
+    cout << "Optimal Path: ";
+    for (int i = 0; i < path.size(); ++i) {
+        cout << path[i];
+        if (i < path.size() - 1) cout << " -> ";
+    }
+    cout << endl;
+}
+
 // Function to reconstruct and print the path from source to a node using parent array
 // Parameters:
 // - node: The destination node
@@ -85,18 +1534,874 @@ void printPath(int node, const vector<int>& parent) {
 
     // Reverse the path to get it from source to destination
     reverse(path.begin(), path.end());
+    printPath(path);
+}
 
-    // Print the path
-    cout << "Optimal Path: ";
-    for (int i = 0; i < path.size(); ++i) {
-        cout << path[i];
-        if (i < path.size() - 1) cout << " -> ";
+// Function to generate a road network: a grid of intersections with random travel
+// times, numbered in random order (as intersections from a real data set would be)
+// Parameters:
+// - V: Number of intersections (rounded down to a full grid)
+// - seed: Random seed
+// - zeroPercent: Share of roads (in percent) that take 0 minutes
+vector<Road> generateRoads(int& V, unsigned seed, int zeroPercent = 0) {
+    int side = 1;
+    while ((long long)(side + 1) * (side + 1) <= V) side++;
+    V = side * side;
+    mt19937 rng(seed);
+    vector<int> id(V);
+    for (int i = 0; i < V; i++) id[i] = i;
+    shuffle(id.begin(), id.end(), rng);
+
+    vector<Road> roads;
+    roads.reserve(2 * V);
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            int u = id[r * side + c];
+            if (c + 1 < side) roads.push_back({u, id[r * side + c + 1], 1 + int(rng() % 100)});
+            if (r + 1 < side) roads.push_back({u, id[(r + 1) * side + c], 1 + int(rng() % 100)});
+        }
     }
-    cout << endl;
+    shuffle(roads.begin(), roads.end(), rng);
+    if (zeroPercent > 0) {
+        for (Road& r : roads) {
+            if (int(rng() % 100) < zeroPercent) r.w = 0;
+        }
+    }
+    return roads;
+}
+
+// Function to compare the adjacency list with the CSR layouts on a random road network
+// Parameters:
+// - V: Number of intersections
+// - queries: Number of random Dijkstra queries per layout
+// Returns false if any layout gives different distances or paths.
+bool benchmarkRouting(int V, int queries) {
+    vector<Road> roads = generateRoads(V, 1);
+    cout << "Road grid: " << V << " intersections, " << roads.size() << " roads\n";
+    auto seconds = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double>(b - a).count();
+    };
+
+    auto begin = chrono::steady_clock::now();
+    vector<vector<iPair>> graph(V);
+    for (const Road& r : roads) {
+        graph[r.u].push_back({r.v, r.w});
+        graph[r.v].push_back({r.u, r.w});
+    }
+    double listBuild = seconds(begin, chrono::steady_clock::now());
+    size_t listBytes = graph.size() * sizeof(vector<iPair>);
+    for (const auto& edges : graph) listBytes += edges.capacity() * sizeof(iPair);
+
+    mt19937 rng(2);
+    vector<int> sources(queries);
+    for (int& s : sources) s = rng() % V;
+
+    // Reference answers from the adjacency list
+    vector<vector<int>> refDist(queries), refParent(queries);
+    begin = chrono::steady_clock::now();
+    for (int q = 0; q < queries; q++) dijkstra(sources[q], graph, refDist[q], refParent[q]);
+    double listQuery = seconds(begin, chrono::steady_clock::now()) / queries;
+
+    cout << fixed << setprecision(3);
+    cout << "  layout       build (s)  memory (MB)  query (ms)\n";
+    auto report = [&](const string& name, double build, size_t bytes, double query) {
+        cout << "  " << left << setw(12) << name << right << setw(10) << build << setw(13) << bytes / 1e6
+             << setw(12) << query * 1e3 << "\n";
+    };
+    report("adjacency", listBuild, listBytes, listQuery);
+    graph.clear();
+    graph.shrink_to_fit();
+
+    bool ok = true;
+    for (string mode : {"none", "bfs", "rcm"}) {
+        begin = chrono::steady_clock::now();
+        CsrGraph g = buildCsr(V, roads);
+        if (mode != "none") g = reorderGraph(g, vertexOrder(g, mode));
+        double build = seconds(begin, chrono::steady_clock::now());
+
+        vector<int> dist, parent;
+        double query = 0;
+        for (int q = 0; q < queries; q++) {
+            begin = chrono::steady_clock::now();
+            dijkstra(sources[q], g, dist, parent);
+            query += seconds(begin, chrono::steady_clock::now());
+            if (dist != refDist[q] || parent != refParent[q]) {
+                cout << "Error: CSR (" << mode << ") differs from the adjacency list for source "
+                     << sources[q] << ".\n";
+                ok = false;
+            }
+        }
+        report("csr " + mode, build, g.bytes(), query / queries);
+    }
+
+    // Priority queues on the unordered CSR graph
+    CsrGraph g = buildCsr(V, roads);
+    cout << "  queue (max travel time " << g.maxWeight << ", auto = " << queueName(chooseQueue(g, QueueKind::Auto))
+         << ")\n  kind         pushes/query  decreases  pops/query  stale/query  query (ms)\n";
+    for (QueueKind kind : {QueueKind::Binary, QueueKind::Radix, QueueKind::Dial, QueueKind::FourAry}) {
+        QueueStats total;
+        vector<int> dist, parent;
+        double query = 0;
+        for (int q = 0; q < queries; q++) {
+            begin = chrono::steady_clock::now();
+            QueueStats stats = dijkstra(sources[q], g, dist, parent, kind);
+            query += seconds(begin, chrono::steady_clock::now());
+            total.pushes += stats.pushes;
+            total.decreases += stats.decreases;
+            total.pops += stats.pops;
+            total.stale += stats.stale;
+            if (dist != refDist[q] || parent != refParent[q]) {
+                cout << "Error: " << queueName(kind) << " queue differs from the adjacency list for source "
+                     << sources[q] << ".\n";
+                ok = false;
+            }
+        }
+        cout << "  " << left << setw(12) << queueName(kind) << right << setprecision(0)
+             << setw(13) << double(total.pushes) / queries << setw(11) << double(total.decreases) / queries
+             << setw(12) << double(total.pops) / queries << setw(13) << double(total.stale) / queries
+             << setprecision(3) << setw(12) << query / queries * 1e3 << "\n";
+    }
+    if (ok) cout << "  All layouts and queues give identical distances and paths.\n";
+
+    // Ties over 0-minute roads, which settle vertices at equal distances
+    int zeroV = min(V, 2500);
+    vector<Road> zeroRoads = generateRoads(zeroV, 5, 30);
+    graph.assign(zeroV, {});
+    for (const Road& r : zeroRoads) {
+        graph[r.u].push_back({r.v, r.w});
+        graph[r.v].push_back({r.u, r.w});
+    }
+    bool zeroOk = true;
+    for (int q = 0; q < min(queries, 20); q++) {
+        int src = rng() % zeroV;
+        vector<int> refD, refP, dist, parent;
+        dijkstra(src, graph, refD, refP);
+        for (string mode : {"none", "rcm"}) {
+            CsrGraph z = buildCsr(zeroV, zeroRoads);
+            if (mode != "none") z = reorderGraph(z, vertexOrder(z, mode));
+            for (QueueKind kind : {QueueKind::Binary, QueueKind::Radix, QueueKind::Dial, QueueKind::FourAry}) {
+                dijkstra(src, z, dist, parent, kind);
+                if (dist != refD || parent != refP) {
+                    cout << "Error: CSR (" << mode << ", " << queueName(kind)
+                         << ") differs from the adjacency list with 0-minute roads for source " << src << ".\n";
+                    zeroOk = false;
+                }
+            }
+        }
+    }
+    if (zeroOk) cout << "  With 30% 0-minute roads, all layouts and queues still give identical paths.\n";
+    return ok && zeroOk;
+}
+
+// Function to compare the three ways of finding the nearest hospital on a random road network
+// Parameters:
+// - V: Number of intersections
+// - queries: Number of random start locations
+// - H: Number of random hospitals
+// Returns false if a method gives a different hospital or time than the full search.
+bool benchmarkDispatch(int V, int queries, int H) {
+    vector<Road> roads = generateRoads(V, 1);
+    CsrGraph g = buildCsr(V, roads);
+    mt19937 rng(3);
+    vector<int> hospitals(H), sources(queries);
+    for (int& h : hospitals) h = rng() % V;
+    for (int& s : sources) s = rng() % V;
+    auto seconds = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double>(b - a).count();
+    };
+    cout << "Dispatch: " << V << " intersections, " << H << " hospitals, " << queries << " start locations\n";
+
+    // Full search plus scan (the reference)
+    vector<Dispatch> reference(queries);
+    vector<int> dist, parent;
+    auto begin = chrono::steady_clock::now();
+    for (int q = 0; q < queries; q++) {
+        dijkstra(sources[q], g, dist, parent);
+        for (int h : hospitals) {
+            if (dist[h] < reference[q].time) {
+                reference[q].time = dist[h];
+                reference[q].hospital = h;
+            }
+        }
+        if (reference[q].hospital != -1) {
+            for (int u = reference[q].hospital; u != -1; u = parent[u]) reference[q].path.push_back(u);
+            reverse(reference[q].path.begin(), reference[q].path.end());
+        }
+    }
+    double full = seconds(begin, chrono::steady_clock::now()) / queries;
+
+    // Early-terminating search
+    bool ok = true;
+    HospitalFinder finder(g, hospitals, QueueKind::Auto);
+    size_t settled = 0;
+    double nearest = 0;
+    for (int q = 0; q < queries; q++) {
+        begin = chrono::steady_clock::now();
+        Dispatch d = finder.find(sources[q]);
+        nearest += seconds(begin, chrono::steady_clock::now());
+        settled += finder.settled;
+        if (d.hospital != reference[q].hospital || d.time != reference[q].time || d.path != reference[q].path) {
+            cout << "Error: early-terminating search differs for start " << sources[q] << ".\n";
+            ok = false;
+        }
+    }
+    nearest /= queries;
+
+    // Precomputed table
+    QueueStats stats;
+    begin = chrono::steady_clock::now();
+    vector<HospitalRoute> table = hospitalTable(g, hospitals, QueueKind::Auto, stats);
+    double build = seconds(begin, chrono::steady_clock::now());
+    double lookup = 0;
+    for (int q = 0; q < queries; q++) {
+        begin = chrono::steady_clock::now();
+        Dispatch d = dispatchFromTable(table, sources[q]);
+        lookup += seconds(begin, chrono::steady_clock::now());
+        if (d.hospital != reference[q].hospital || d.time != reference[q].time ||
+            (d.hospital != -1 && d.path.back() != d.hospital)) {
+            cout << "Error: hospital table differs for start " << sources[q] << ".\n";
+            ok = false;
+        }
+    }
+    lookup /= queries;
+
+    cout << "  full search + scan:  " << full * 1e3 << " ms/query\n";
+    cout << "  early termination:   " << nearest * 1e3 << " ms/query (" << settled / queries
+         << " intersections reached on average)\n";
+    cout << "  hospital table:      " << build * 1e3 << " ms to build, " << lookup * 1e6 << " us/lookup\n";
+    if (ok) cout << "  All methods agree on hospital and time.\n";
+
+    // Ties over 0-minute roads, where equally near hospitals are common
+    int zeroV = min(V, 2500);
+    vector<Road> zeroRoads = generateRoads(zeroV, 6, 30);
+    CsrGraph z = buildCsr(zeroV, zeroRoads);
+    for (int& h : hospitals) h = rng() % zeroV;
+    HospitalFinder zeroFinder(z, hospitals, QueueKind::Auto);
+    vector<HospitalRoute> zeroTable = hospitalTable(z, hospitals, QueueKind::Auto, stats);
+    bool zeroOk = true;
+    for (int q = 0; q < queries; q++) {
+        int src = rng() % zeroV;
+        Dispatch ref;
+        dijkstra(src, z, dist, parent);
+        for (int h : hospitals) {
+            if (dist[h] < ref.time) {
+                ref.time = dist[h];
+                ref.hospital = h;
+            }
+        }
+        for (int u = ref.hospital; u != -1; u = parent[u]) ref.path.push_back(u);
+        reverse(ref.path.begin(), ref.path.end());
+        Dispatch early = zeroFinder.find(src), fromTable = dispatchFromTable(zeroTable, src);
+        if (early.hospital != ref.hospital || early.time != ref.time || early.path != ref.path ||
+            fromTable.hospital != ref.hospital || fromTable.time != ref.time ||
+            (ref.hospital != -1 && fromTable.path.back() != ref.hospital)) {
+            cout << "Error: dispatch differs with 0-minute roads for start " << src << ".\n";
+            zeroOk = false;
+        }
+    }
+    if (zeroOk) cout << "  With 30% 0-minute roads, all methods still agree.\n";
+    return ok && zeroOk;
+}
+
+// Function to compare DynamicPaths repair with recomputation on a random road network
+// Parameters:
+// - V: Number of intersections
+// - batches: Batch sizes (number of random road changes per batch)
+// Returns false if a repair differs from recomputation.
+bool benchmarkUpdates(int V, const vector<int>& batches) {
+    mt19937 rng(4);
+    auto seconds = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double>(b - a).count();
+    };
+    vector<int> dist, parent;
+
+    // Function to time the batches on a road network with zeroPercent% 0-minute roads
+    auto table = [&](int zeroPercent) {
+        vector<Road> roads = generateRoads(V, 1, zeroPercent);
+        CsrGraph g = buildCsr(V, roads);
+        int source = rng() % V;
+        auto begin = chrono::steady_clock::now();
+        DynamicPaths paths(g, source);
+        double initial = seconds(begin, chrono::steady_clock::now());
+        if (zeroPercent == 0) {
+            cout << "Traffic updates: " << V << " intersections, initial search " << initial * 1e3 << " ms\n";
+        } else {
+            cout << "  With " << zeroPercent << "% 0-minute roads, initial search " << initial * 1e3 << " ms\n";
+        }
+        cout << "  batch     repair (ms)  recompute (ms)  vertices repaired\n";
+
+        bool ok = true;
+        for (int size : batches) {
+            // Random roads get slower or faster (travel times stay within 1..100, or
+            // within 0..100 next to 0-minute roads)
+            vector<Road> changes(size);
+            for (Road& c : changes) {
+                c = roads[rng() % roads.size()];
+                c.w = zeroPercent > 0 && rng() % 3 == 0 ? 0 : 1 + rng() % 100;
+            }
+            begin = chrono::steady_clock::now();
+            paths.update(changes);
+            double repair = seconds(begin, chrono::steady_clock::now());
+
+            begin = chrono::steady_clock::now();
+            dijkstra(source, g, dist, parent);
+            double recompute = seconds(begin, chrono::steady_clock::now());
+
+            for (int id = 0; id < V && ok; id++) {
+                if (paths.distance(id) != dist[id] || paths.parentOf(id) != parent[id]) {
+                    cout << "Error: repair differs from recomputation at intersection " << id << ".\n";
+                    ok = false;
+                }
+            }
+            cout << "  " << left << setw(10) << size << right << setw(11) << repair * 1e3 << setw(16)
+                 << recompute * 1e3 << setw(19) << paths.repaired << "\n";
+        }
+        if (ok) cout << "  All repairs match recomputation.\n";
+        return ok;
+    };
+    bool ok = table(0);
+    ok = table(30) && ok;
+
+    // Roads that start or stop taking 0 minutes
+    int zeroV = min(V, 2500);
+    vector<Road> zeroRoads = generateRoads(zeroV, 7, 30);
+    CsrGraph z = buildCsr(zeroV, zeroRoads);
+    int zeroSource = rng() % zeroV;
+    DynamicPaths zeroPaths(z, zeroSource);
+    bool zeroOk = true;
+    for (int batch = 0; batch < 50 && zeroOk; batch++) {
+        vector<Road> changes(1 + rng() % 20);
+        for (Road& c : changes) {
+            c = zeroRoads[rng() % zeroRoads.size()];
+            c.w = rng() % 3 == 0 ? 0 : 1 + rng() % 100;
+        }
+        zeroPaths.update(changes);
+        dijkstra(zeroSource, z, dist, parent);
+        for (int id = 0; id < zeroV; id++) {
+            if (zeroPaths.distance(id) != dist[id] || zeroPaths.parentOf(id) != parent[id]) {
+                cout << "Error: repair differs from recomputation with 0-minute roads at intersection " << id << ".\n";
+                zeroOk = false;
+                break;
+            }
+        }
+    }
+    if (zeroOk) cout << "  With 0-minute roads coming and going, all repairs still match.\n";
+    return ok && zeroOk;
+}
+
+// Fixed group of threads that run one task together at a time. run(task) calls
+// task(t) on every thread t (the caller is thread 0) and returns when all are done.
+class ThreadTeam {
+public:
+    explicit ThreadTeam(int threads) : count(max(1, threads)) {
+        for (int t = 1; t < count; t++) workers.emplace_back([this, t] { work(t); });
+    }
+    ~ThreadTeam() {
+        {
+            lock_guard<mutex> lock(m);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    void run(const function<void(int)>& job) {
+        {
+            lock_guard<mutex> lock(m);
+            task = &job;
+            pending = count - 1;
+            generation++;
+        }
+        wake.notify_all();
+        job(0);
+        unique_lock<mutex> lock(m);
+        finished.wait(lock, [&] { return pending == 0; });
+    }
+
+    int size() const { return count; }
+
+private:
+    void work(int t) {
+        size_t seen = 0;
+        while (true) {
+            const function<void(int)>* job;
+            {
+                unique_lock<mutex> lock(m);
+                wake.wait(lock, [&] { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+                job = task;
+            }
+            (*job)(t);
+            lock_guard<mutex> lock(m);
+            if (--pending == 0) finished.notify_one();
+        }
+    }
+
+    int count;
+    vector<thread> workers;
+    mutex m;
+    condition_variable wake, finished;
+    const function<void(int)>* task = nullptr;
+    size_t generation = 0;
+    int pending = 0;
+    bool stop = false;
+};
+
+// Work done by a delta-stepping run
+struct DeltaStats {
+    size_t buckets = 0;      // Non-empty buckets settled
+    size_t phases = 0;       // Parallel relaxation rounds
+    size_t improvements = 0; // Successful distance updates
+};
+
+// Function to pick a bucket width: about the largest travel time over the average degree
+int defaultDelta(const CsrGraph& g) {
+    if (g.arcs.empty()) return 1;
+    return max(1, int((long long)g.maxWeight * g.vertices() / g.arcs.size()));
+}
+
+// Function to compute shortest paths with delta-stepping, in the graph's own numbering
+// Bucket i holds the vertices with a tentative distance in [i * delta, (i + 1) * delta).
+// While bucket i is settled every tentative distance lies below (i + 1) * delta +
+// maxWeight, so, as in DialQueue, maxWeight / delta + 2 buckets reused cyclically
+// suffice; delta is widened if needed to keep that within DELTA_MAX_BUCKETS.
+// The lowest non-empty bucket is settled by rounds in which the threads take its
+// vertices in chunks and relax their light roads (travel time <= delta), lowering
+// distances with compare-and-swap and collecting improved vertices in per-thread
+// buffers; the buffers are then sorted into buckets. Vertices that land back in the
+// current bucket form the next round. Heavy roads cannot lead back into the bucket, so
+// they are relaxed once, after its last round. Parents are chosen afterwards, in
+// parallel, with the rule dijkstraCsr() uses (smallest distance, then input number).
+// That per-vertex choice can make two vertices joined by a 0-minute road each other's
+// parent, so on graphs with 0-minute roads ParentChooser replays the settle order
+// instead (sequentially).
+DeltaStats deltaSteppingCsr(int src, const CsrGraph& g, int delta, ThreadTeam& team, vector<int>& dist,
+                            vector<int>& parent) {
+    int V = g.vertices(), T = team.size();
+    vector<atomic<int>> d(V), relaxedAt(V);
+    auto slices = [&](function<void(int, int)> body) {
+        team.run([&](int t) { body(int((long long)V * t / T), int((long long)V * (t + 1) / T)); });
+    };
+    slices([&](int first, int last) {
+        for (int u = first; u < last; u++) {
+            d[u].store(INT_MAX, memory_order_relaxed);
+            relaxedAt[u].store(INT_MAX, memory_order_relaxed);
+        }
+    });
+
+    DeltaStats stats;
+    delta = max(delta, g.maxWeight / (DELTA_MAX_BUCKETS - 2) + 1);
+    size_t slots = size_t(g.maxWeight / delta) + 2;
+    vector<vector<int>> buckets(slots);
+    buckets[0].push_back(src);
+    size_t pending = 1;  // Entries filed in buckets (stale ones included)
+    d[src].store(0);
+    vector<vector<int>> improved(T), settledBy(T);
+    vector<char> inSettled(V, 0);
+    vector<int> frontier, settled;
+    atomic<size_t> nextChunk;
+    const size_t CHUNK = 64;
+
+    // Function to relax the roads of list (light or heavy ones) on all threads
+    auto relaxAll = [&](const vector<int>& list, bool light, size_t bucket) {
+        nextChunk.store(0);
+        stats.phases++;
+        team.run([&](int t) {
+            for (size_t first; (first = nextChunk.fetch_add(CHUNK)) < list.size();) {
+                for (size_t k = first; k < min(first + CHUNK, list.size()); k++) {
+                    int u = list[k];
+                    int du = d[u].load(memory_order_relaxed);
+                    if (light) {
+                        // Skip vertices that left the bucket or were already relaxed at this distance
+                        if (size_t(du / delta) != bucket || relaxedAt[u].exchange(du) == du) continue;
+                        settledBy[t].push_back(u);
+                    }
+                    for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++) {
+                        int w = g.arcs[i].weight;
+                        if ((w <= delta) != light) continue;
+                        int v = g.arcs[i].to, nd = du + w;
+                        int cur = d[v].load(memory_order_relaxed);
+                        while (nd < cur) {
+                            if (d[v].compare_exchange_weak(cur, nd, memory_order_relaxed)) {
+                                improved[t].push_back(v);
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+        });
+        // File the improved vertices into buckets (the current one becomes the next round)
+        for (int t = 0; t < T; t++) {
+            stats.improvements += improved[t].size();
+            for (int v : improved[t]) {
+                size_t b = d[v].load(memory_order_relaxed) / delta;
+                if (b == bucket) {
+                    frontier.push_back(v);
+                } else {
+                    buckets[b % slots].push_back(v);
+                    pending++;
+                }
+            }
+            improved[t].clear();
+            for (int u : settledBy[t]) {
+                if (!inSettled[u]) {
+                    inSettled[u] = 1;
+                    settled.push_back(u);
+                }
+            }
+            settledBy[t].clear();
+        }
+    };
+
+    for (size_t i = 0; pending > 0; i++) {
+        vector<int>& bucket = buckets[i % slots];
+        if (bucket.empty()) continue;
+        stats.buckets++;
+        pending -= bucket.size();
+        frontier = move(bucket);
+        bucket = vector<int>();
+        while (!frontier.empty()) {
+            vector<int> round = move(frontier);
+            frontier.clear();
+            relaxAll(round, true, i);
+        }
+        relaxAll(settled, false, i);
+        for (int u : settled) inSettled[u] = 0;
+        settled.clear();
+    }
+
+    // Distances are final: copy them out and choose parents
+    dist.resize(V);
+    parent.resize(V);
+    slices([&](int first, int last) {
+        for (int v = first; v < last; v++) dist[v] = d[v].load(memory_order_relaxed);
+    });
+    if (g.zeroArcs > 0) {
+        vector<int> order;
+        for (int v = 0; v < V; v++) {
+            parent[v] = -1;
+            if (dist[v] != INT_MAX) order.push_back(v);
+        }
+        sort(order.begin(), order.end(), [&](int a, int b) { return dist[a] < dist[b]; });
+        ParentChooser(V).choose(g, order, dist, {{src, 0}}, parent);
+        return stats;
+    }
+    slices([&](int first, int last) {
+        for (int v = first; v < last; v++) {
+            int best = -1;
+            if (v != src && dist[v] != INT_MAX) {
+                for (int i = g.offsets[v]; i < g.offsets[v + 1]; i++) {
+                    int u = g.arcs[i].to;
+                    if (dist[u] == INT_MAX || dist[u] + g.arcs[i].weight != dist[v]) continue;
+                    if (best == -1 || dist[u] < dist[best] || (dist[u] == dist[best] && g.inputId(u) < g.inputId(best))) {
+                        best = u;
+                    }
+                }
+            }
+            parent[v] = best;
+        }
+    });
+    return stats;
+}
+
+// Function to compute shortest paths from source with delta-stepping
+// Parameters and results are in input numbering, as for dijkstra().
+// - delta: Bucket width
+// - team: Threads to use
+DeltaStats deltaStepping(int src, const CsrGraph& g, vector<int>& dist, vector<int>& parent, int delta,
+                         ThreadTeam& team) {
+    if (g.label.empty()) return deltaSteppingCsr(src, g, delta, team, dist, parent);
+    vector<int> d, p;
+    DeltaStats stats = deltaSteppingCsr(g.vertexOf(src), g, delta, team, d, p);
+    int V = g.vertices();
+    dist.resize(V);
+    parent.resize(V);
+    for (int u = 0; u < V; u++) {
+        dist[g.label[u]] = d[u];
+        parent[g.label[u]] = p[u] == -1 ? -1 : g.label[p[u]];
+    }
+    return stats;
+}
+
+// Function to check that a path is a chain of roads whose fastest travel times add up to time
+bool validRoute(const CsrGraph& g, const vector<int>& path, int time) {
+    long long total = 0;
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        iPair range = arcRange(g, g.vertexOf(path[i]), g.vertexOf(path[i + 1]));
+        if (range.first == range.second) return false;
+        int fastest = INT_MAX;
+        for (int a = range.first; a < range.second; a++) fastest = min(fastest, g.arcs[a].weight);
+        total += fastest;
+    }
+    return total == time;
+}
+
+// Function to check contraction hierarchies against dijkstra() and measure them
+// Parameters:
+// - V: Number of intersections of the road grid to measure on
+// - queries: Number of random source-target queries
+// Returns false if any hierarchy answer differs from dijkstra().
+bool benchmarkHierarchy(int V, int queries) {
+    auto seconds = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double>(b - a).count();
+    };
+    bool ok = true;
+    mt19937 rng(5);
+
+    // Randomized check: small random graphs with parallel roads and several components
+    int checked = 0;
+    for (int trial = 0; trial < 40; trial++) {
+        int n = 20 + rng() % 300, m = n + rng() % (3 * n);
+        vector<Road> roads(m);
+        for (Road& r : roads) r = {int(rng() % n), int(rng() % n), 1 + int(rng() % 20)};
+        CsrGraph g = buildCsr(n, roads);
+        size_t shortcuts;
+        ContractionHierarchy ch = buildHierarchy(g, shortcuts);
+        ChRouter router(ch);
+        vector<int> hospitals(1 + rng() % 5);
+        for (int& h : hospitals) h = rng() % n;
+        HospitalFinder finder(g, hospitals, QueueKind::Auto);
+        vector<int> dist, parent;
+        for (int q = 0; q < 25; q++) {
+            int s = rng() % n, t = rng() % n;
+            dijkstra(s, g, dist, parent);
+            Dispatch d = router.route(s, t);
+            bool reachable = dist[t] != INT_MAX;
+            if (d.time != dist[t] || (reachable && (d.path.front() != s || d.path.back() != t ||
+                                                    !validRoute(g, d.path, d.time)))) {
+                cout << "Error: hierarchy differs from dijkstra() on random graph " << trial << " from "
+                     << s << " to " << t << ".\n";
+                ok = false;
+            }
+            Dispatch expected = finder.find(s), found = router.nearest(s, hospitals);
+            if (found.hospital != expected.hospital || found.time != expected.time ||
+                (found.hospital != -1 && !validRoute(g, found.path, found.time))) {
+                cout << "Error: hierarchy picks another hospital on random graph " << trial << " from " << s << ".\n";
+                ok = false;
+            }
+            checked++;
+        }
+    }
+    cout << "Contraction hierarchy: " << checked << " random-graph routes and dispatches checked against dijkstra()\n";
+
+    // Road grid: preprocessing, file round trip and query latency
+    vector<Road> roads = generateRoads(V, 1);
+    CsrGraph g = buildCsr(V, roads);
+    size_t shortcuts;
+    auto begin = chrono::steady_clock::now();
+    ContractionHierarchy built = buildHierarchy(g, shortcuts);
+    double preprocess = seconds(begin, chrono::steady_clock::now());
+
+    string path = "asg4_bench.ch";
+    uint64_t fingerprint = graphFingerprint(g);
+    ContractionHierarchy ch;
+    begin = chrono::steady_clock::now();
+    if (!saveHierarchy(built, fingerprint, path)) return false;
+    double save = seconds(begin, chrono::steady_clock::now());
+    begin = chrono::steady_clock::now();
+    bool loaded = loadHierarchy(ch, g.vertices(), fingerprint, path);
+    double load = seconds(begin, chrono::steady_clock::now());
+    remove(path.c_str());
+    if (!loaded || ch.arcs.size() != built.arcs.size()) {
+        cout << "Error: hierarchy file round trip failed.\n";
+        return false;
+    }
+
+    cout << "  road grid: " << V << " intersections, " << roads.size() << " roads\n";
+    cout << "  preprocessing: " << preprocess << " s, " << shortcuts << " shortcuts, index "
+         << ch.bytes() / 1e6 << " MB (graph " << g.bytes() / 1e6 << " MB)\n";
+    cout << "  file: saved in " << save * 1e3 << " ms, loaded in " << load * 1e3 << " ms\n";
+
+    ChRouter router(ch);
+    vector<double> latency;
+    vector<int> dist, parent;
+    size_t searched = 0;
+    int compared = min(queries, 20);
+    double dijkstraTime = 0;
+    for (int q = 0; q < queries; q++) {
+        int s = rng() % V, t = rng() % V;
+        begin = chrono::steady_clock::now();
+        Dispatch d = router.route(s, t);
+        latency.push_back(seconds(begin, chrono::steady_clock::now()));
+        searched += router.searched;
+        if (q < compared) {
+            begin = chrono::steady_clock::now();
+            dijkstra(s, g, dist, parent);
+            dijkstraTime += seconds(begin, chrono::steady_clock::now());
+            if (d.time != dist[t] || !validRoute(g, d.path, d.time)) {
+                cout << "Error: hierarchy differs from dijkstra() from " << s << " to " << t << ".\n";
+                ok = false;
+            }
+        }
+    }
+    sort(latency.begin(), latency.end());
+    auto percentile = [&](double p) { return latency[min(latency.size() - 1, size_t(p * latency.size()))] * 1e6; };
+    cout << "  query latency (us): p50 " << percentile(0.5) << ", p90 " << percentile(0.9) << ", p99 "
+         << percentile(0.99) << ", max " << latency.back() * 1e6 << "; " << searched / queries
+         << " vertices searched on average\n";
+    cout << "  dijkstra(): " << dijkstraTime / compared * 1e3 << " ms per query\n";
+    if (ok) cout << "  All hierarchy answers match dijkstra().\n";
+    return ok;
+}
+
+// Function to measure delta-stepping against dijkstra() for 1 to maxThreads threads
+// Parameters:
+// - V: Number of intersections of the random road grid
+// - maxThreads: Largest thread count to measure
+// - delta: Bucket width (0 for defaultDelta())
+// Returns false if any run differs from dijkstra().
+bool benchmarkDelta(int V, int maxThreads, int delta) {
+    vector<Road> roads = generateRoads(V, 1);
+    CsrGraph g = buildCsr(V, roads);
+    if (delta <= 0) delta = defaultDelta(g);
+    int source = mt19937(6)() % V;
+    auto seconds = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double>(b - a).count();
+    };
+
+    vector<int> refDist, refParent, dist, parent;
+    auto begin = chrono::steady_clock::now();
+    dijkstra(source, g, refDist, refParent);
+    double dijkstraTime = seconds(begin, chrono::steady_clock::now());
+    cout << fixed << setprecision(2);
+    cout << "Delta-stepping: " << V << " intersections, delta " << delta << " (max travel time "
+         << g.maxWeight << "), " << thread::hardware_concurrency() << " hardware threads\n";
+    cout << "  dijkstra(): " << dijkstraTime * 1e3 << " ms\n";
+
+    // Time the best of three runs for each thread count
+    bool ok = true;
+    auto measure = [&](int threads, int width, DeltaStats& stats) {
+        ThreadTeam team(threads);
+        double best = 0;
+        for (int run = 0; run < 3; run++) {
+            begin = chrono::steady_clock::now();
+            stats = deltaStepping(source, g, dist, parent, width, team);
+            double time = seconds(begin, chrono::steady_clock::now());
+            if (run == 0 || time < best) best = time;
+            if (dist != refDist || parent != refParent) {
+                cout << "Error: delta-stepping with " << threads << " threads and delta " << width
+                     << " differs from dijkstra().\n";
+                ok = false;
+            }
+        }
+        return best;
+    };
+
+    vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+    cout << "  threads   time (ms)   speedup\n";
+    double single = 0;
+    DeltaStats stats;
+    for (int threads : counts) {
+        double time = measure(threads, delta, stats);
+        if (threads == 1) single = time;
+        double speedup = single / time;
+        cout << "  " << setw(7) << threads << setw(12) << time * 1e3 << setw(10) << speedup << "x  "
+             << string(max(1, int(speedup * 4 + 0.5)), '#') << "\n";
+    }
+    cout << "  " << stats.buckets << " buckets, " << stats.phases << " rounds, " << stats.improvements
+         << " distance updates per run\n";
+
+    // Bucket width at the largest thread count
+    cout << "  delta     time (ms)   rounds\n";
+    vector<int> widths = {max(1, delta / 4), delta, delta * 4, g.maxWeight};
+    sort(widths.begin(), widths.end());
+    widths.erase(unique(widths.begin(), widths.end()), widths.end());
+    for (int width : widths) {
+        double time = measure(maxThreads, width, stats);
+        cout << "  " << setw(7) << width << setw(12) << time * 1e3 << setw(9) << stats.phases << "\n";
+    }
+    if (ok) cout << "  All runs match dijkstra() exactly (distances and parents).\n";
+
+    // Ties over 0-minute roads
+    int zeroV = min(V, 2500);
+    vector<Road> zeroRoads = generateRoads(zeroV, 8, 30);
+    CsrGraph z = buildCsr(zeroV, zeroRoads);
+    int zeroSource = mt19937(9)() % zeroV;
+    dijkstra(zeroSource, z, refDist, refParent);
+    bool zeroOk = true;
+    for (int width : {1, defaultDelta(z), z.maxWeight}) {
+        ThreadTeam team(maxThreads);
+        deltaStepping(zeroSource, z, dist, parent, width, team);
+        if (dist != refDist || parent != refParent) {
+            cout << "Error: delta-stepping with delta " << width << " differs from dijkstra() with 0-minute roads.\n";
+            zeroOk = false;
+        }
+    }
+    if (zeroOk) cout << "  With 30% 0-minute roads, all runs still match.\n";
+    return ok && zeroOk;
 }
 
 // Main function: Entry point of the program
-int main() {
+int main(int argc, char* argv[]) {
+    // Command-line options: vertex order for the interactive run, or benchmark mode
+    string order = "none";
+    QueueKind queue = QueueKind::Auto;
+    string dispatch = "nearest", chFile;
+    int threads = thread::hardware_concurrency(), delta = 0;
+    bool stats = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--order=", 0) == 0 && (arg == "--order=none" || arg == "--order=bfs" || arg == "--order=rcm")) {
+            order = arg.substr(8);
+        } else if (arg.rfind("--queue=", 0) == 0) {
+            string name = arg.substr(8);
+            QueueKind kinds[] = {QueueKind::Auto, QueueKind::Binary, QueueKind::Radix, QueueKind::Dial, QueueKind::FourAry};
+            auto found = find_if(begin(kinds), end(kinds), [&](QueueKind k) { return queueName(k) == name; });
+            if (found == end(kinds)) {
+                cout << "Error: Unknown queue " << name << "." << endl;
+                return 1;
+            }
+            queue = *found;
+        } else if (arg == "--dispatch=full" || arg == "--dispatch=nearest" || arg == "--dispatch=table" ||
+                   arg == "--dispatch=ch" || arg == "--dispatch=delta") {
+            dispatch = arg.substr(11);
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            threads = max(1, stoi(arg.substr(10)));
+        } else if (arg.rfind("--delta=", 0) == 0) {
+            delta = stoi(arg.substr(8));
+        } else if (arg.rfind("--delta-bench=", 0) == 0) {
+            size_t comma = arg.find(',');
+            int V = stoi(arg.substr(14));
+            int maxThreads = comma == string::npos ? max(1u, thread::hardware_concurrency()) : stoi(arg.substr(comma + 1));
+            return benchmarkDelta(V, maxThreads, delta) ? 0 : 1;
+        } else if (arg.rfind("--ch-file=", 0) == 0) {
+            chFile = arg.substr(10);
+        } else if (arg.rfind("--ch-bench=", 0) == 0) {
+            size_t comma = arg.find(',');
+            int V = stoi(arg.substr(11));
+            int queries = comma == string::npos ? 1000 : stoi(arg.substr(comma + 1));
+            return benchmarkHierarchy(V, queries) ? 0 : 1;
+        } else if (arg.rfind("--update-bench=", 0) == 0) {
+            vector<int> values;
+            for (size_t pos = 15; pos < arg.size();) {
+                size_t comma = arg.find(',', pos);
+                if (comma == string::npos) comma = arg.size();
+                values.push_back(stoi(arg.substr(pos, comma - pos)));
+                pos = comma + 1;
+            }
+            if (values.size() == 1) values.insert(values.end(), {1, 10, 100, 1000, 10000});
+            return benchmarkUpdates(values[0], vector<int>(values.begin() + 1, values.end())) ? 0 : 1;
+        } else if (arg == "--stats") {
+            stats = true;
+        } else if (arg.rfind("--bench=", 0) == 0) {
+            size_t comma = arg.find(',');
+            size_t comma2 = comma == string::npos ? comma : arg.find(',', comma + 1);
+            int V = stoi(arg.substr(8));
+            int queries = comma == string::npos ? 10 : stoi(arg.substr(comma + 1));
+            int H = comma2 == string::npos ? 20 : stoi(arg.substr(comma2 + 1));
+            bool ok = benchmarkRouting(V, queries);
+            cout << "\n";
+            return ok && benchmarkDispatch(V, queries, H) ? 0 : 1;
+        } else {
+            cout << "Usage: " << argv[0] << " [--order=none|bfs|rcm] [--queue=auto|binary|radix|dial|4ary] [--dispatch=full|nearest|table|ch|delta] [--ch-file=PATH] [--threads=N] [--delta=D] [--stats] [--bench=V[,Q[,H]]] [--update-bench=V[,B...]] [--ch-bench=V[,Q]] [--delta-bench=V[,N]]" << endl;
+            return 1;
+        }
+    }
+
     // Variables for number of vertices (intersections) and edges (roads)
     int V, E;
     cout << "Enter number of intersections (vertices): ";
@@ -104,15 +2409,14 @@ int main() {
     cout << "Enter number of roads (edges): ";
     cin >> E;
 
-    // Adjacency list to represent the graph (undirected)
-    vector<vector<iPair>> graph(V);
+    // Read the roads (undirected) and pack them into a CSR graph
+    vector<Road> roads(E);
     cout << "Enter roads (u v travel time):\n";
     for (int i = 0; i < E; i++) {
-        int u, v, w;
-        cin >> u >> v >> w;
-        graph[u].push_back({v, w});  // Add edge u -> v
-        graph[v].push_back({u, w});  // Add edge v -> u (undirected)
+        cin >> roads[i].u >> roads[i].v >> roads[i].w;
     }
+    CsrGraph graph = buildCsr(V, roads);
+    if (order != "none") graph = reorderGraph(graph, vertexOrder(graph, order));
 
     // Option to update travel times due to traffic
     char update;
@@ -123,14 +2427,8 @@ int main() {
         cout << "Enter road to update (u v new_travel time): ";
         cin >> u >> v >> w;
 
-        // Update the edge u -> v
-        for (auto& edge : graph[u]) {
-            if (edge.first == v) edge.second = w;
-        }
-        // Update the edge v -> u
-        for (auto& edge : graph[v]) {
-            if (edge.first == u) edge.second = w;
-        }
+        // Update the edges u -> v and v -> u
+        setTravelTime(graph, u, v, w);
 
         cout << "Update another road? (y/n): ";
         cin >> update;
@@ -151,26 +2449,56 @@ int main() {
         cin >> hospitals[i];
     }
 
-    // Vectors to store distances and parents from Dijkstra's
-    vector<int> dist, parent;
-    dijkstra(source, graph, dist, parent);
-
     // Find the nearest hospital
-    int nearestHospital = -1, minTime = INT_MAX;
-    for (int h : hospitals) {
-        if (dist[h] < minTime) {
-            minTime = dist[h];
-            nearestHospital = h;
+    Dispatch nearest;
+    QueueStats counts;
+    if (dispatch == "full" || dispatch == "delta") {
+        // Shortest paths over the whole graph, then scan the hospitals
+        vector<int> dist, parent;
+        if (dispatch == "full") {
+            counts = dijkstra(source, graph, dist, parent, queue);
+        } else {
+            ThreadTeam team(threads);
+            deltaStepping(source, graph, dist, parent, delta > 0 ? delta : defaultDelta(graph), team);
+        }
+        for (int h : hospitals) {
+            if (dist[h] < nearest.time) {
+                nearest.time = dist[h];
+                nearest.hospital = h;
+            }
         }
+        for (int u = nearest.hospital; u != -1; u = parent[u]) nearest.path.push_back(u);
+        reverse(nearest.path.begin(), nearest.path.end());
+    } else if (dispatch == "ch") {
+        // Contraction hierarchy, reused from --ch-file when it matches these roads
+        ContractionHierarchy ch;
+        uint64_t fingerprint = graphFingerprint(graph);
+        if (chFile.empty() || !loadHierarchy(ch, graph.vertices(), fingerprint, chFile)) {
+            size_t shortcuts;
+            ch = buildHierarchy(graph, shortcuts);
+            if (!chFile.empty()) saveHierarchy(ch, fingerprint, chFile);
+        }
+        ChRouter router(ch);
+        nearest = router.nearest(source, hospitals);
+    } else if (dispatch == "nearest") {
+        HospitalFinder finder(graph, hospitals, queue);
+        nearest = finder.find(source);
+        counts = finder.stats;
+    } else {
+        nearest = dispatchFromTable(hospitalTable(graph, hospitals, queue, counts), source);
+    }
+    if (stats && dispatch != "ch" && dispatch != "delta") {
+        cout << "Queue " << queueName(chooseQueue(graph, queue)) << ": " << counts.pushes << " pushes, "
+             << counts.decreases << " decrease-keys, " << counts.pops << " pops (" << counts.stale << " stale)\n";
     }
 
     // Output the result
-    if (nearestHospital == -1 || dist[nearestHospital] == INT_MAX) {
+    if (nearest.hospital == -1) {
         cout << "No hospital reachable.\n";
     } else {
-        cout << "\nNearest hospital is at node " << nearestHospital
-             << " with estimated time " << minTime << " minutes.\n";
-        printPath(nearestHospital, parent);  // Print the path
+        cout << "\nNearest hospital is at node " << nearest.hospital
+             << " with estimated time " << nearest.time << " minutes.\n";
+        printPath(nearest.path);  // Print the path
     }
 
     return 0;  // Successful execution
@@ -5,6 +5,23 @@
  * in a graph of nodes (cities) and edges (routes with costs). It computes the minimum cost path
  * from the first node to the last node and reconstructs the optimal route.
  *
+ * Routes are kept in a compressed sparse row (CSR) list: an offsets array and, per city,
+ * its outgoing routes sorted by destination. Only routes to a higher-numbered city can
+ * be used (the numbering is the topological order), and a route given twice keeps its
+ * last cost, as the original cost matrix did. The DP visits every city and route once,
+ * O(N + E) time and memory, and accumulates costs in 64 bits so long routes cannot
+ * overflow.
+ *
+ * When at least a quarter of all city pairs have a route, the DP runs on the upper triangle
+ * of the cost matrix in one contiguous buffer instead: each dp[i] is a branch-free SIMD
+ * min-plus reduction (saturating 32-bit sentinel for missing routes), blocked so a tile of
+ * dp is reused by several rows. --dense-bench compares it with the scalar loop.
+ *
+ * With --serve the program stays up and answers batches of (source, destination) queries
+ * from standard input, or one batch from a binary file with --queries. Each destination's
+ * DP table answers every source, so tables are computed on demand (in parallel for the
+ * destinations a batch is missing) and kept in an LRU cache of --cache-mb megabytes.
+ *
  * Key concepts: Dynamic programming, shortest path, path reconstruction.
  */
 
@@ -12,38 +29,276 @@
 #include <vector>       // For dynamic arrays (vector)
 #include <limits>       // For numeric limits (numeric_limits)
 #include <algorithm>    // For algorithms (though not heavily used here)
+#include <string>       // For command-line options
+#include <list>         // For the destination table LRU list
+#include <unordered_map>  // For the destination table cache
+#include <memory>       // For shared destination tables
+#include <thread>       // For computing destination tables in parallel
+#include <atomic>       // For handing destinations to threads
+#include <chrono>       // For timing query batches
+#include <random>       // For benchmark networks and queries
+#include <iomanip>      // For formatting statistics
+#include <cstdio>       // For query files
+#include <cstdint>      // For fixed-width query file fields
+#include <cstring>      // For the query file magic
+#include <cstdlib>      // For absolute route costs (llabs)
+#ifdef __SSE2__
+#include <immintrin.h>  // For the dense min-plus kernel (SSE2, SSE4.1 and AVX2 when enabled)
+#endif
 
 using namespace std;  // Use the standard namespace
 
-// Define infinity as the maximum int value
-const int INF = numeric_limits<int>::max();
+// Define infinity as the maximum 64-bit value (costs are accumulated in 64 bits)
+const long long INF = numeric_limits<long long>::max();
 
-// Function to find the optimal route using dynamic programming
+// A direct route to another city
+struct Route {
+    int to;    // Destination city
+    int cost;  // Cost of the route
+};
+
+// Routes in compressed sparse row form: the routes leaving city i are
+// routes[offsets[i]] .. routes[offsets[i + 1] - 1], sorted by destination
+struct RouteGraph {
+    vector<int> offsets;
+    vector<Route> routes;
+
+    int nodes() const { return int(offsets.size()) - 1; }
+};
+
+// An input line: source destination cost
+struct RouteInput {
+    int u, v, cost;
+};
+
+// Function to build the route graph from the input routes
+// Routes with an index out of range or that do not lead to a higher-numbered city are
+// dropped; if a route is given more than once, the last cost counts.
 // Parameters:
 // - N: Number of nodes (cities)
-// - costMatrix: 2D vector representing the cost between nodes (INF if no direct route)
-void findOptimalRoute(int N, const vector<vector<int>>& costMatrix) {
+// - input: Routes in input order
+RouteGraph buildRouteGraph(int N, const vector<RouteInput>& input) {
+    RouteGraph g;
+    g.offsets.assign(N + 1, 0);
+    auto usable = [&](const RouteInput& r) { return r.u >= 0 && r.u < N && r.v > r.u && r.v < N; };
+    for (const RouteInput& r : input) {
+        if (usable(r)) g.offsets[r.u + 1]++;
+    }
+    for (int i = 0; i < N; i++) g.offsets[i + 1] += g.offsets[i];
+
+    // Place routes by source in input order, then sort each city's routes by destination
+    g.routes.resize(g.offsets[N]);
+    vector<int> next(g.offsets.begin(), g.offsets.end() - 1);
+    for (const RouteInput& r : input) {
+        if (usable(r)) g.routes[next[r.u]++] = {r.v, r.cost};
+    }
+    int kept = 0;
+    for (int i = 0; i < N; i++) {
+        auto first = g.routes.begin() + g.offsets[i], last = g.routes.begin() + g.offsets[i + 1];
+        stable_sort(first, last, [](const Route& a, const Route& b) { return a.to < b.to; });
+        g.offsets[i] = kept;
+        // Keep the last of each run of routes to the same destination
+        for (auto it = first; it != last; ++it) {
+            if (it + 1 != last && (it + 1)->to == it->to) continue;
+            g.routes[kept++] = *it;
+        }
+    }
+    g.offsets[N] = kept;
+    g.routes.resize(kept);
+    g.routes.shrink_to_fit();
+    return g;
+}
+
+// Function to run the route DP over the sparse route list
+// dp[i] is the minimum cost from city i to the last city (INF if there is no route) and
+// path[i] the next city on that route.
+void routeDp(const RouteGraph& g, vector<long long>& dp, vector<int>& path) {
+    int N = g.nodes();
     // DP array to store minimum cost to reach each node from the end
-    vector<int> dp(N, 0);
+    dp.assign(N, 0);
     // Path array to store the next node in the optimal path
-    vector<int> path(N, 0);
+    path.assign(N, 0);
 
     // Fill DP table from the second last node to the first
     for (int i = N - 2; i >= 0; --i) {
         dp[i] = INF;  // Initialize to infinity
-        for (int j = i + 1; j < N; ++j) {
-            // If there is a direct route from i to j
-            if (costMatrix[i][j] != INF) {
-                // If dp[j] is not infinity (reachable)
-                if (dp[j] != INF) {
-                    int cost = costMatrix[i][j] + dp[j];  // Total cost to go i -> j -> end
-                    if (cost < dp[i]) {
-                        dp[i] = cost;  // Update minimum cost
-                        path[i] = j;   // Record the next node
-                    }
+        // Routes from i in increasing destination order, so ties keep the lowest j
+        for (int k = g.offsets[i]; k < g.offsets[i + 1]; ++k) {
+            int j = g.routes[k].to;
+            // If dp[j] is not infinity (reachable)
+            if (dp[j] != INF) {
+                long long cost = g.routes[k].cost + dp[j];  // Total cost to go i -> j -> end
+                if (cost < dp[i]) {
+                    dp[i] = cost;  // Update minimum cost
+                    path[i] = j;   // Record the next node
+                }
+            }
+        }
+    }
+}
+
+// Saturating sentinel of the dense kernel: a missing route or an unreachable city costs
+// DENSE_INF, and any sum at or above DENSE_LIMIT is unreachable. Two sentinels still add
+// up without overflow, so the kernel needs no reachability branches.
+const int32_t DENSE_INF = numeric_limits<int32_t>::max() / 2;
+const int32_t DENSE_LIMIT = DENSE_INF / 2;
+
+// Rows processed together by denseRouteDp(), and columns per tile (a tile of dp stays
+// in L1 while every row of the block reads it)
+const int DENSE_ROW_BLOCK = 16;
+const int DENSE_COLUMN_TILE = 2048;
+
+// Upper triangle of the cost matrix in one contiguous row-major buffer: row i holds the
+// costs from city i to cities i + 1 .. n - 1 (DENSE_INF where there is no route)
+struct DenseRoutes {
+    int n = 0;
+    vector<int32_t> costs;
+
+    const int32_t* row(int i) const { return costs.data() + size_t(i) * n - size_t(i) * (i + 1) / 2; }
+    int32_t* row(int i) { return costs.data() + size_t(i) * n - size_t(i) * (i + 1) / 2; }
+};
+
+// Whether a route graph should use the dense kernel: at least a quarter of all city
+// pairs have a route (so the triangle is at most twice the size of the route list), and
+// every route cost is bounded well below DENSE_LIMIT so no 32-bit sum can overflow
+bool useDenseRoutes(const RouteGraph& g) {
+    int N = g.nodes();
+    long long pairs = (long long)N * (N - 1) / 2, maxCost = 0;
+    if (N < 2 || (long long)g.routes.size() * 4 < pairs) return false;
+    for (const Route& r : g.routes) maxCost = max(maxCost, llabs((long long)r.cost));
+    return (N - 1) * maxCost < DENSE_LIMIT;
+}
+
+// Function to copy a route graph into the dense triangle
+DenseRoutes buildDenseRoutes(const RouteGraph& g) {
+    DenseRoutes m;
+    m.n = g.nodes();
+    m.costs.assign(size_t(m.n) * (m.n - 1) / 2, DENSE_INF);
+    for (int i = 0; i < m.n; i++) {
+        int32_t* row = m.row(i);
+        for (int k = g.offsets[i]; k < g.offsets[i + 1]; k++) row[g.routes[k].to - i - 1] = g.routes[k].cost;
+    }
+    return m;
+}
+
+// Function to find the minimum of a[k] + b[k] over k < len (DENSE_INF if len is 0)
+// Uses eight lanes at a time with AVX2, four with SSE2 (min from SSE4.1 when available).
+int32_t minPlus(const int32_t* a, const int32_t* b, int len) {
+    int k = 0;
+    int32_t best = DENSE_INF;
+#if defined(__AVX2__)
+    __m256i best8 = _mm256_set1_epi32(DENSE_INF);
+    for (; k + 8 <= len; k += 8) {
+        __m256i sum = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k)),
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k)));
+        best8 = _mm256_min_epi32(best8, sum);
+    }
+    __m128i best4 = _mm_min_epi32(_mm256_castsi256_si128(best8), _mm256_extracti128_si256(best8, 1));
+#elif defined(__SSE2__)
+    __m128i best4 = _mm_set1_epi32(DENSE_INF);
+#endif
+#if defined(__SSE2__)
+    auto min4 = [](__m128i x, __m128i y) {
+#if defined(__SSE4_1__)
+        return _mm_min_epi32(x, y);
+#else
+        __m128i greater = _mm_cmpgt_epi32(x, y);
+        return _mm_or_si128(_mm_and_si128(greater, y), _mm_andnot_si128(greater, x));
+#endif
+    };
+    for (; k + 4 <= len; k += 4) {
+        __m128i sum = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + k)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + k)));
+        best4 = min4(best4, sum);
+    }
+    best4 = min4(best4, _mm_shuffle_epi32(best4, 0x4E));
+    best4 = min4(best4, _mm_shuffle_epi32(best4, 0xB1));
+    best = _mm_cvtsi128_si32(best4);
+#endif
+    for (; k < len; k++) best = min(best, a[k] + b[k]);
+    return best;
+}
+
+// Function to find the first k < len with a[k] + b[k] == value (the value must occur)
+int firstMinPlus(const int32_t* a, const int32_t* b, int len, int32_t value) {
+    int k = 0;
+#if defined(__SSE2__)
+    const __m128i target = _mm_set1_epi32(value);
+    for (; k + 4 <= len; k += 4) {
+        __m128i sum = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + k)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + k)));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(sum, target)));
+        if (mask != 0) return k + __builtin_ctz(mask);
+    }
+#endif
+    while (a[k] + b[k] != value) k++;
+    return k;
+}
+
+// Function to run the route DP over the dense triangle
+// Same results as routeDp() (costs in 32 bits, DENSE_INF for unreachable). Every dp[i]
+// is a min-plus reduction of row i against dp[i + 1 .. n); ties keep the lowest j.
+// Rows are taken in blocks of DENSE_ROW_BLOCK: the columns past the block are already
+// final, so they are reduced tile by tile for all rows of the block, then the small
+// triangle inside the block is finished from its last row up.
+void denseRouteDp(const DenseRoutes& m, vector<int32_t>& dp, vector<int>& path) {
+    int N = m.n;
+    dp.assign(N, DENSE_INF);
+    path.assign(N, 0);
+    if (N == 0) return;
+    dp[N - 1] = 0;
+    int32_t best[DENSE_ROW_BLOCK];
+    int next[DENSE_ROW_BLOCK];
+    for (int top = N - 2; top >= 0; top -= DENSE_ROW_BLOCK) {
+        int bottom = max(0, top - DENSE_ROW_BLOCK + 1);
+        fill(best, best + DENSE_ROW_BLOCK, DENSE_INF);
+        fill(next, next + DENSE_ROW_BLOCK, 0);
+
+        // Columns after the block, one tile at a time (a tile only wins with a strictly
+        // lower sum, so an earlier tile keeps its ties)
+        for (int first = top + 1; first < N; first += DENSE_COLUMN_TILE) {
+            int len = min(N - first, DENSE_COLUMN_TILE);
+            for (int i = bottom; i <= top; i++) {
+                const int32_t* row = m.row(i) + (first - i - 1);
+                int32_t tile = minPlus(row, dp.data() + first, len);
+                if (tile < best[i - bottom]) {
+                    best[i - bottom] = tile;
+                    next[i - bottom] = first + firstMinPlus(row, dp.data() + first, len, tile);
                 }
             }
         }
+
+        // Columns inside the block come first, so they win ties
+        for (int i = top; i >= bottom; i--) {
+            int32_t inner = minPlus(m.row(i), dp.data() + i + 1, top - i);
+            int32_t& b = best[i - bottom];
+            if (inner < DENSE_LIMIT && inner <= b) {
+                b = inner;
+                next[i - bottom] = i + 1 + firstMinPlus(m.row(i), dp.data() + i + 1, top - i, inner);
+            }
+            bool reachable = b < DENSE_LIMIT;
+            dp[i] = reachable ? b : DENSE_INF;
+            path[i] = reachable ? next[i - bottom] : 0;
+        }
+    }
+}
+
+// Function to find the optimal route using dynamic programming
+// Parameters:
+// - g: Routes between the nodes (cities)
+void findOptimalRoute(const RouteGraph& g) {
+    int N = g.nodes();
+    vector<long long> dp;
+    vector<int> path;
+    if (useDenseRoutes(g)) {
+        vector<int32_t> dense;
+        denseRouteDp(buildDenseRoutes(g), dense, path);
+        dp.assign(dense.begin(), dense.end());
+        for (long long& d : dp) {
+            if (d == DENSE_INF) d = INF;
+        }
+    } else {
+        routeDp(g, dp, path);
     }
 
     // Output the results
@@ -65,8 +320,483 @@ void findOptimalRoute(int N, const vector<vector<int>>& costMatrix) {
     cout << "----------------------------------------\n";
 }
 
+// Minimum costs from every city to one destination t: cost[i] is the cheapest route
+// i -> t (INF if there is none) and next[i] the city after i on it. Only cities 0..t
+// can reach t, so both arrays stop at t.
+struct DestinationTable {
+    int destination;
+    vector<long long> cost;
+    vector<int> next;
+
+    size_t bytes() const { return sizeof(DestinationTable) + cost.size() * sizeof(long long) + next.size() * sizeof(int); }
+};
+
+// Function to compute the DP table for one destination
+// Same recurrence and tie rule (lowest next city) as findOptimalRoute(), which is this
+// table for t = N - 1 read at city 0. Routes past t are skipped, using the per-city
+// destination order.
+shared_ptr<DestinationTable> computeDestination(const RouteGraph& g, int t) {
+    auto table = make_shared<DestinationTable>();
+    table->destination = t;
+    table->cost.assign(t + 1, INF);
+    table->next.assign(t + 1, t);
+    table->cost[t] = 0;
+    for (int i = t - 1; i >= 0; --i) {
+        for (int k = g.offsets[i]; k < g.offsets[i + 1] && g.routes[k].to <= t; ++k) {
+            int j = g.routes[k].to;
+            if (table->cost[j] != INF && g.routes[k].cost + table->cost[j] < table->cost[i]) {
+                table->cost[i] = g.routes[k].cost + table->cost[j];
+                table->next[i] = j;
+            }
+        }
+    }
+    return table;
+}
+
+// A (source, destination) query
+struct RouteQuery {
+    int src, dst;
+};
+
+// Answer to a query: the minimum cost (INF if there is no route) and, if requested,
+// the route from src to dst
+struct RouteAnswer {
+    long long cost;
+    vector<int> route;
+};
+
+// Query server over one route graph. Destination tables are computed on first use and
+// kept in a least-recently-used cache bounded by a byte budget. A batch is answered
+// destination by destination in groups that fit the budget; the tables a group is
+// missing are independent, so they are computed in parallel.
+class RouteServer {
+public:
+    size_t hits = 0, misses = 0;  // Destination tables found / not found in the cache (one lookup per batch)
+    size_t shared = 0;            // Queries answered by a table an earlier query of the batch looked up
+    size_t evictions = 0;         // Tables evicted
+
+    RouteServer(const RouteGraph& g, size_t cacheBytes, int threads)
+        : g(g), budget(cacheBytes), threads(max(1, threads)) {}
+
+    // Function to answer a batch of queries (answers in query order)
+    vector<RouteAnswer> answer(const vector<RouteQuery>& queries, bool withRoutes) {
+        int N = g.nodes();
+        vector<RouteAnswer> answers(queries.size(), RouteAnswer{INF, {}});
+
+        // Queries with a valid destination, grouped by destination
+        vector<int> order;
+        for (size_t q = 0; q < queries.size(); q++) {
+            const RouteQuery& r = queries[q];
+            if (r.src >= 0 && r.src <= r.dst && r.dst < N) order.push_back(q);
+        }
+        stable_sort(order.begin(), order.end(), [&](int a, int b) { return queries[a].dst < queries[b].dst; });
+
+        for (size_t first = 0; first < order.size();) {
+            // Take destinations while their tables fit the budget (always at least one)
+            vector<int> group;
+            size_t last = first, groupBytes = 0;
+            while (last < order.size()) {
+                int t = queries[order[last]].dst;
+                size_t bytes = tableBytes(t);
+                if (!group.empty() && groupBytes + bytes > budget) break;
+                group.push_back(t);
+                groupBytes += bytes;
+                while (last < order.size() && queries[order[last]].dst == t) last++;
+            }
+
+            size_t computed;
+            vector<shared_ptr<DestinationTable>> tables = prepare(group, computed);
+            for (size_t k = first, d = 0; k < last; k++) {
+                const RouteQuery& r = queries[order[k]];
+                while (tables[d]->destination != r.dst) d++;
+                const DestinationTable& table = *tables[d];
+                RouteAnswer& a = answers[order[k]];
+                a.cost = table.cost[r.src];
+                if (withRoutes && a.cost != INF) {
+                    for (int city = r.src; city != r.dst; city = table.next[city]) a.route.push_back(city);
+                    a.route.push_back(r.dst);
+                }
+            }
+            // Each destination is looked up once per batch; its other queries share the table
+            misses += computed;
+            hits += group.size() - computed;
+            shared += last - first - group.size();
+            first = last;
+        }
+        return answers;
+    }
+
+    size_t cachedTables() const { return cache.size(); }
+    size_t cachedBytes() const { return used; }
+
+private:
+    const RouteGraph& g;
+    size_t budget, used = 0;
+    int threads;
+    list<shared_ptr<DestinationTable>> lru;  // Most recently used first
+    unordered_map<int, list<shared_ptr<DestinationTable>>::iterator> cache;
+
+    size_t tableBytes(int t) const { return sizeof(DestinationTable) + size_t(t + 1) * (sizeof(long long) + sizeof(int)); }
+
+    // Function to look up or compute the tables of a group of destinations
+    // computed is set to the number of tables that were not cached.
+    vector<shared_ptr<DestinationTable>> prepare(const vector<int>& group, size_t& computed) {
+        vector<shared_ptr<DestinationTable>> tables(group.size());
+        vector<int> missing;
+        for (size_t d = 0; d < group.size(); d++) {
+            auto found = cache.find(group[d]);
+            if (found == cache.end()) {
+                missing.push_back(d);
+            } else {
+                lru.splice(lru.begin(), lru, found->second);
+                tables[d] = *found->second;
+            }
+        }
+
+        // Compute the missing tables, one destination at a time per thread
+        atomic<size_t> nextMissing(0);
+        auto work = [&]() {
+            for (size_t m; (m = nextMissing++) < missing.size();) {
+                tables[missing[m]] = computeDestination(g, group[missing[m]]);
+            }
+        };
+        vector<thread> workers;
+        for (int w = 1; w < min<int>(threads, missing.size()); w++) workers.emplace_back(work);
+        work();
+        for (auto& w : workers) w.join();
+
+        // Cache them, evicting least recently used tables; the group's own cached tables
+        // are at the front and fit the budget with the new ones, so they stay
+        computed = missing.size();
+        for (int d : missing) {
+            size_t bytes = tables[d]->bytes();
+            if (bytes > budget) continue;
+            while (used + bytes > budget) {
+                used -= lru.back()->bytes();
+                cache.erase(lru.back()->destination);
+                lru.pop_back();
+                evictions++;
+            }
+            lru.push_front(tables[d]);
+            cache[group[d]] = lru.begin();
+            used += bytes;
+        }
+        return tables;
+    }
+};
+
+// Header at the start of a binary query file, followed by count (src, dst) int32 pairs
+struct QueryFileHeader {
+    char magic[4];      // Always "RQRY"
+    uint32_t version;   // Format version (QUERY_FILE_VERSION)
+    uint64_t count;     // Number of queries
+    uint64_t reserved;
+};
+
+// Current query file format version
+const uint32_t QUERY_FILE_VERSION = 1;
+
+// Most queries reserved up front for a batch read from standard input (larger batches
+// grow as their queries arrive, so a mistyped count cannot exhaust memory)
+const size_t QUERY_RESERVE_LIMIT = 1 << 20;
+
+// Function to write queries to a binary query file
+bool saveQueries(const vector<RouteQuery>& queries, const string& path) {
+    QueryFileHeader header = {};
+    memcpy(header.magic, "RQRY", 4);
+    header.version = QUERY_FILE_VERSION;
+    header.count = queries.size();
+    FILE* file = fopen(path.c_str(), "wb");
+    bool ok = file && fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(queries.data(), sizeof(RouteQuery), queries.size(), file) == queries.size();
+    if (file && fclose(file) != 0) ok = false;
+    if (!ok) cout << "Error: Cannot write " << path << "." << endl;
+    return ok;
+}
+
+// Function to read a binary query file written by saveQueries()
+// The header's count is checked against the file size before anything is allocated,
+// so a corrupt or truncated file is reported rather than trusted.
+bool loadQueries(vector<RouteQuery>& queries, const string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    QueryFileHeader header = {};
+    bool ok = file && fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, "RQRY", 4) == 0 &&
+              header.version == QUERY_FILE_VERSION;
+    if (ok) {
+        long start = ftell(file);
+        ok = start >= 0 && fseek(file, 0, SEEK_END) == 0;
+        long end = ok ? ftell(file) : -1;
+        ok = ok && end >= start && fseek(file, start, SEEK_SET) == 0 &&
+             header.count == uint64_t(end - start) / sizeof(RouteQuery);
+    }
+    if (ok) {
+        queries.resize(header.count);
+        ok = fread(queries.data(), sizeof(RouteQuery), queries.size(), file) == queries.size() && fgetc(file) == EOF;
+    }
+    if (file) fclose(file);
+    if (!ok) cout << "Error: Cannot read query file " << path << "." << endl;
+    return ok;
+}
+
+// Function to answer one batch of queries, print the answers and the batch statistics
+void serveBatch(RouteServer& server, const vector<RouteQuery>& queries, bool withRoutes) {
+    size_t hits = server.hits, misses = server.misses, shared = server.shared;
+    auto begin = chrono::steady_clock::now();
+    vector<RouteAnswer> answers = server.answer(queries, withRoutes);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    for (size_t q = 0; q < queries.size(); q++) {
+        cout << queries[q].src << " -> " << queries[q].dst << ": ";
+        if (answers[q].cost == INF) {
+            cout << "no route\n";
+            continue;
+        }
+        cout << answers[q].cost;
+        for (size_t k = 0; k < answers[q].route.size(); k++) cout << (k ? " -> " : " (") << answers[q].route[k];
+        cout << (answers[q].route.empty() ? "\n" : ")\n");
+    }
+    size_t lookups = server.hits - hits + server.misses - misses;
+    cout << "Batch: " << queries.size() << " queries in " << fixed << setprecision(3) << seconds * 1e3 << " ms ("
+         << setprecision(0) << queries.size() / max(seconds, 1e-9) << " queries/sec), cache hit rate "
+         << setprecision(1) << (lookups ? 100.0 * (server.hits - hits) / lookups : 0.0) << "% of " << lookups
+         << " destinations (" << server.shared - shared << " queries shared a destination), " << server.cachedTables() << " tables / " << setprecision(1) << server.cachedBytes() / 1048576.0
+         << " MB cached\n" << defaultfloat;
+}
+
+// Function to generate a random forward-only network: every city has a few routes to
+// cities up to 64 ahead, with costs 1..100
+RouteGraph randomRouteGraph(int N, int perCity, mt19937& rng) {
+    vector<RouteInput> input;
+    for (int u = 0; u + 1 < N; u++) {
+        for (int k = 0; k < perCity; k++) {
+            input.push_back({u, min(N - 1, u + 1 + int(rng() % 64)), 1 + int(rng() % 100)});
+        }
+    }
+    return buildRouteGraph(N, input);
+}
+
+// Function to generate dispatcher queries: most go to a small set of busy destinations
+vector<RouteQuery> randomQueries(int N, size_t count, mt19937& rng) {
+    vector<int> busy(256);
+    for (int& t : busy) t = rng() % N;
+    vector<RouteQuery> queries(count);
+    for (RouteQuery& q : queries) {
+        q.dst = rng() % 10 < 9 ? busy[rng() % busy.size()] : rng() % N;
+        q.src = rng() % (q.dst + 1);
+    }
+    return queries;
+}
+
+// Function to benchmark the dense kernel against the scalar route DP on complete networks
+// (90% of city pairs have a route, costs 1..1000), checking that costs and routes agree
+// Parameters:
+// - sizes: Numbers of cities
+// Returns false if the kernel differs from the scalar loop.
+bool benchmarkDense(const vector<int>& sizes) {
+    auto seconds = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double>(b - a).count();
+    };
+#if defined(__AVX2__)
+    const char* isa = "AVX2";
+#elif defined(__SSE4_1__)
+    const char* isa = "SSE4.1";
+#elif defined(__SSE2__)
+    const char* isa = "SSE2";
+#else
+    const char* isa = "scalar";
+#endif
+    cout << "Dense min-plus kernel (" << isa << "), GFLOP-equivalent = 2 operations (add, min) per city pair\n";
+    cout << setw(8) << "cities" << setw(14) << "scalar s" << setw(12) << "GFLOP/s" << setw(14) << "CSR s" << setw(12)
+         << "GFLOP/s" << setw(14) << "kernel s" << setw(12) << "GFLOP/s" << setw(10) << "speedup\n";
+    bool ok = true;
+    mt19937 rng(22);
+    for (int N : sizes) {
+        DenseRoutes m;
+        m.n = N;
+        m.costs.resize(size_t(N) * (N - 1) / 2);
+        for (int32_t& c : m.costs) c = rng() % 10 == 0 ? DENSE_INF : 1 + int32_t(rng() % 1000);
+        double ops = 2.0 * m.costs.size();
+
+        // The scalar loop of findOptimalRoute() over the same triangle, branches included
+        auto begin = chrono::steady_clock::now();
+        vector<long long> expected(N, INF);
+        vector<int> expectedPath(N, 0);
+        expected[N - 1] = 0;
+        for (int i = N - 2; i >= 0; --i) {
+            const int32_t* row = m.row(i);
+            for (int j = i + 1; j < N; ++j) {
+                if (row[j - i - 1] != DENSE_INF && expected[j] != INF) {
+                    long long cost = row[j - i - 1] + expected[j];
+                    if (cost < expected[i]) {
+                        expected[i] = cost;
+                        expectedPath[i] = j;
+                    }
+                }
+            }
+        }
+        double scalar = seconds(begin, chrono::steady_clock::now());
+
+        // The sparse route list, while it fits next to the triangle
+        double csr = 0;
+        if (N <= 16384) {
+            RouteGraph g;
+            g.offsets.assign(N + 1, 0);
+            for (int i = 0; i < N; i++) {
+                const int32_t* row = m.row(i);
+                for (int j = i + 1; j < N; j++) {
+                    if (row[j - i - 1] != DENSE_INF) g.routes.push_back({j, row[j - i - 1]});
+                }
+                g.offsets[i + 1] = g.routes.size();
+            }
+            vector<long long> dp;
+            vector<int> path;
+            begin = chrono::steady_clock::now();
+            routeDp(g, dp, path);
+            csr = seconds(begin, chrono::steady_clock::now());
+            if (dp != expected || path != expectedPath) {
+                cout << "Error: route list DP differs from the scalar loop at " << N << " cities.\n";
+                ok = false;
+            }
+        }
+
+        vector<int32_t> dp;
+        vector<int> path;
+        begin = chrono::steady_clock::now();
+        denseRouteDp(m, dp, path);
+        double kernel = seconds(begin, chrono::steady_clock::now());
+        for (int i = 0; i < N; i++) {
+            if ((dp[i] == DENSE_INF ? INF : dp[i]) != expected[i] || path[i] != expectedPath[i]) {
+                cout << "Error: dense kernel differs from the scalar loop at " << N << " cities, city " << i << ".\n";
+                ok = false;
+                break;
+            }
+        }
+
+        cout << setw(8) << N << fixed << setprecision(3) << setw(14) << scalar << setw(12) << ops / scalar / 1e9;
+        if (csr > 0) {
+            cout << setw(14) << csr << setw(12) << ops / csr / 1e9;
+        } else {
+            cout << setw(14) << "-" << setw(12) << "-";
+        }
+        cout << setw(14) << kernel << setw(12) << ops / kernel / 1e9 << setprecision(1) << setw(9) << scalar / kernel
+             << "x\n" << defaultfloat;
+    }
+    return ok;
+}
+
+// Function to benchmark the query server on a random network and check its answers
+// against a forward DP from each checked query's source
+// Parameters:
+// - N: Number of cities
+// - count: Number of queries, answered in batches of batchSize
+// - cacheBytes, threads: Server settings
+// - queryFile: If not empty, the generated queries are also written there
+// Returns false if any checked answer differs.
+bool benchmarkServer(int N, size_t count, size_t batchSize, size_t cacheBytes, int threads, const string& queryFile) {
+    mt19937 rng(21);
+    RouteGraph g = randomRouteGraph(N, 4, rng);
+    vector<RouteQuery> queries = randomQueries(N, count, rng);
+    if (!queryFile.empty() && !saveQueries(queries, queryFile)) return false;
+
+    RouteServer server(g, cacheBytes, threads);
+    vector<RouteAnswer> answers;
+    auto begin = chrono::steady_clock::now();
+    for (size_t first = 0; first < count; first += batchSize) {
+        vector<RouteQuery> batch(queries.begin() + first, queries.begin() + min(count, first + batchSize));
+        vector<RouteAnswer> part = server.answer(batch, true);
+        answers.insert(answers.end(), make_move_iterator(part.begin()), make_move_iterator(part.end()));
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    // Check a sample: the cost must match a forward DP, and the route must add up to it
+    bool ok = true;
+    size_t checked = min<size_t>(count, 200);
+    vector<long long> dist(N);
+    for (size_t q = 0; q < checked; q++) {
+        int s = queries[q].src, t = queries[q].dst;
+        fill(dist.begin() + s, dist.begin() + t + 1, INF);
+        dist[s] = 0;
+        for (int i = s; i < t; i++) {
+            if (dist[i] == INF) continue;
+            for (int k = g.offsets[i]; k < g.offsets[i + 1] && g.routes[k].to <= t; k++) {
+                dist[g.routes[k].to] = min(dist[g.routes[k].to], dist[i] + g.routes[k].cost);
+            }
+        }
+        long long sum = 0;
+        const vector<int>& route = answers[q].route;
+        for (size_t k = 0; k + 1 < route.size(); k++) {
+            auto first = g.routes.begin() + g.offsets[route[k]], last = g.routes.begin() + g.offsets[route[k] + 1];
+            auto it = lower_bound(first, last, route[k + 1], [](const Route& r, int to) { return r.to < to; });
+            sum = it == last || it->to != route[k + 1] ? INF : sum + it->cost;
+        }
+        bool routeOk = dist[t] == INF ? route.empty() : !route.empty() && route.front() == s && route.back() == t && sum == dist[t];
+        if (answers[q].cost != dist[t] || !routeOk) {
+            cout << "Error: query " << s << " -> " << t << " answered " << answers[q].cost << ", expected " << dist[t] << ".\n";
+            ok = false;
+        }
+    }
+
+    size_t lookups = server.hits + server.misses;
+    cout << "Route server: " << N << " cities, " << g.routes.size() << " routes, " << count << " queries in batches of "
+         << batchSize << ", " << threads << " threads, " << cacheBytes / 1048576 << " MB cache\n";
+    cout << fixed << setprecision(3) << "  " << seconds << " s, " << setprecision(0) << count / seconds
+         << " queries/sec, cache hit rate " << setprecision(1) << 100.0 * server.hits / max<size_t>(lookups, 1)
+         << "% of " << lookups << " destination lookups (" << server.misses << " tables computed, " << server.evictions
+         << " evicted; " << server.shared << " queries shared a destination within a batch)\n" << defaultfloat;
+    cout << "  " << checked << " answers checked against a forward DP: " << (ok ? "ok" : "MISMATCH") << "\n";
+    return ok;
+}
+
 // Main function: Entry point of the program
-int main() {
+int main(int argc, char* argv[]) {
+    // Command-line options: query server mode, or benchmark mode
+    bool serve = false, withRoutes = false;
+    string queryFile, writeQueries;
+    size_t cacheBytes = size_t(256) << 20;
+    int threads = max(1u, thread::hardware_concurrency());
+    vector<long long> bench;  // --serve-bench values: cities, queries, batch size
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--serve") {
+            serve = true;
+        } else if (arg == "--paths") {
+            withRoutes = true;
+        } else if (arg.rfind("--queries=", 0) == 0) {
+            serve = true;
+            queryFile = arg.substr(10);
+        } else if (arg.rfind("--write-queries=", 0) == 0) {
+            writeQueries = arg.substr(16);
+        } else if (arg.rfind("--cache-mb=", 0) == 0) {
+            cacheBytes = size_t(max(1, stoi(arg.substr(11)))) << 20;
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            threads = max(1, stoi(arg.substr(10)));
+        } else if (arg.rfind("--serve-bench=", 0) == 0) {
+            for (size_t pos = 14; pos < arg.size();) {
+                size_t comma = arg.find(',', pos);
+                if (comma == string::npos) comma = arg.size();
+                bench.push_back(stoll(arg.substr(pos, comma - pos)));
+                pos = comma + 1;
+            }
+        } else if (arg.rfind("--dense-bench", 0) == 0) {
+            vector<int> sizes;
+            for (size_t pos = 14; pos < arg.size();) {
+                size_t comma = arg.find(',', pos);
+                if (comma == string::npos) comma = arg.size();
+                sizes.push_back(stoi(arg.substr(pos, comma - pos)));
+                pos = comma + 1;
+            }
+            if (sizes.empty()) sizes = {2048, 4096, 8192, 16384, 32768};
+            return benchmarkDense(sizes) ? 0 : 1;
+        } else {
+            cout << "Usage: " << argv[0] << " [--serve] [--queries=FILE] [--paths] [--cache-mb=M] [--threads=N] [--serve-bench=N[,Q[,B]]] [--write-queries=FILE] [--dense-bench[=N,...]]" << endl;
+            return 1;
+        }
+    }
+    if (!bench.empty()) {
+        size_t count = bench.size() > 1 ? bench[1] : 100000, batch = bench.size() > 2 ? bench[2] : 1000;
+        return benchmarkServer(bench[0], count, batch, cacheBytes, threads, writeQueries) ? 0 : 1;
+    }
+
     // Variables for number of nodes and edges
     int N, E;
     cout << "Enter the total number of nodes: ";
@@ -74,21 +804,40 @@ int main() {
     cout << "Enter the total number of routes (edges): ";
     cin >> E;
 
-    // Initialize cost matrix with INF (no direct routes)
-    vector<vector<int>> costMatrix(N, vector<int>(N, INF));
-
-    // Read edge details and populate the cost matrix
+    // Read edge details (invalid indices are dropped when the route graph is built)
+    vector<RouteInput> input(E);
     cout << "Enter details for each route (source destination cost):" << endl;
     for (int i = 0; i < E; ++i) {
-        int u, v, cost;
-        cin >> u >> v >> cost;
-        // Validate indices and set the cost
-        if (u >= 0 && u < N && v >= 0 && v < N) {
-            costMatrix[u][v] = cost;
-        }
+        cin >> input[i].u >> input[i].v >> input[i].cost;
     }
 
-    // Compute and display the optimal route
-    findOptimalRoute(N, costMatrix);
+    RouteGraph graph = buildRouteGraph(N, input);
+    if (!serve) {
+        // Compute and display the optimal route
+        findOptimalRoute(graph);
+        return 0;  // Successful execution
+    }
+
+    // Query server: one batch from the query file, or batches from standard input
+    RouteServer server(graph, cacheBytes, threads);
+    if (!queryFile.empty()) {
+        vector<RouteQuery> queries;
+        if (!loadQueries(queries, queryFile)) return 1;
+        serveBatch(server, queries, withRoutes);
+        return 0;
+    }
+    cout << "Enter query batches (count, then source destination pairs):" << endl;
+    size_t count;
+    while (cin >> count) {
+        vector<RouteQuery> queries;
+        queries.reserve(min(count, QUERY_RESERVE_LIMIT));
+        RouteQuery q;
+        while (queries.size() < count && cin >> q.src >> q.dst) queries.push_back(q);
+        if (queries.size() < count) {
+            cout << "Error: Expected " << count << " queries but read " << queries.size() << "." << endl;
+            return 1;
+        }
+        serveBatch(server, queries, withRoutes);
+    }
     return 0;  // Successful execution
 }
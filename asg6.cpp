@@ -5,6 +5,22 @@
  * into a truck with a weight capacity. It uses dynamic programming to compute the optimal
  * selection of items and displays the selected items with their values and weights.
  *
+ * The full (n+1) x (W+1) table is only needed to backtrack the chosen items. With --rolling
+ * the fill keeps only the current and the next row, and the chosen items are
+ * recovered by divide and conquer (Hirschberg): a forward pass over all items finds the
+ * capacity at which the backtrack crosses the middle item, and each half is solved on its
+ * own. That is O(W) memory and about twice the work, with the same items as the table.
+ *
+ * Each row is a copy below the item's weight and one contiguous max-add slice above it,
+ * run with AVX-512, AVX2 or scalar code picked at run time (--isa to override). Rolling
+ * rows are split into capacity ranges across threads (--threads), meeting at a barrier
+ * after every item.
+ *
+ * With --quantities every item type also has a number of copies. Types with the same
+ * weight and value are merged, copies that cannot help are dropped (more than fit, or
+ * a type dominated by lighter, more valuable ones that fill the truck), and the rest is
+ * split into 0/1 pieces of 1, 2, 4, ... copies for the same DP.
+ *
  * Key concepts: Dynamic programming, 0/1 knapsack, backtracking for solution reconstruction.
  */
 
@@ -12,6 +28,16 @@
 #include <vector>      // For dynamic arrays (vector)
 #include <string>      // For string handling
 #include <iomanip>     // For output formatting (though not heavily used here)
+#include <algorithm>   // For max, fill
+#include <climits>     // For INT_MAX (the largest value a DP cell holds)
+#include <chrono>      // For timing the benchmark
+#include <random>      // For benchmark items
+#include <thread>      // For splitting DP rows across threads
+#include <mutex>       // For the row barrier
+#include <condition_variable>  // For the row barrier
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // For the AVX2 and AVX-512 row kernels
+#endif
 
 using namespace std;  // Use the standard namespace
 
@@ -22,57 +48,737 @@ struct Item {
     int weight;    // Weight of the item
 };
 
-// Function to solve the 0/1 knapsack problem using dynamic programming
+// Subproblems of the rolling reconstruction with at most this many table cells are
+// solved with a small 2-D table (1 MB)
+const long long HIRSCHBERG_BASE_CELLS = 1 << 18;
+
+// Work and memory of one knapsack solve
+struct KnapsackStats {
+    long long cells = 0;    // DP cells filled, reconstruction included
+    size_t peakBytes = 0;   // Largest DP storage held at once
+};
+
+// Instruction sets of the DP row kernel, chosen at run time
+enum class Isa { Scalar, Avx2, Avx512 };
+
+// Function to name an instruction set
+const char* isaName(Isa isa) {
+    return isa == Isa::Avx512 ? "avx512" : isa == Isa::Avx2 ? "avx2" : "scalar";
+}
+
+// Function to check whether this CPU can run an instruction set
+bool isaSupported(Isa isa) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (isa == Isa::Avx512) return __builtin_cpu_supports("avx512f");
+    if (isa == Isa::Avx2) return __builtin_cpu_supports("avx2");
+#endif
+    return isa == Isa::Scalar;
+}
+
+// How the DP rows are updated: instruction set and number of threads
+struct DpKernel {
+    Isa isa = Isa::Scalar;
+    int threads = 1;
+};
+
+// Capacities each thread gets at least (smaller rows use fewer threads)
+const int MIN_CELLS_PER_THREAD = 1 << 15;
+
+// Function to update count cells of a DP row: next[k] = max(prev[k], shifted[k] + value),
+// where shifted is the previous row at k - weight. If split rows are given, nextSplit[k]
+// takes shiftedSplit[k] where the item is taken (strictly better) and prevSplit[k] where not.
+void maxAddScalar(const int* prev, const int* shifted, int* next, const int* prevSplit, const int* shiftedSplit,
+                  int* nextSplit, int count, int value) {
+    for (int k = 0; k < count; ++k) {
+        int with = shifted[k] + value;
+        bool take = with > prev[k];
+        next[k] = take ? with : prev[k];
+        if (nextSplit) nextSplit[k] = take ? shiftedSplit[k] : prevSplit[k];
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// maxAddScalar() eight cells at a time (AVX2)
+__attribute__((target("avx2")))
+void maxAddAvx2(const int* prev, const int* shifted, int* next, const int* prevSplit, const int* shiftedSplit,
+                int* nextSplit, int count, int value) {
+    const __m256i add = _mm256_set1_epi32(value);
+    int k = 0;
+    for (; k + 8 <= count; k += 8) {
+        __m256i old = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + k));
+        __m256i with = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(shifted + k)), add);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(next + k), _mm256_max_epi32(old, with));
+        if (nextSplit) {
+            __m256i take = _mm256_cmpgt_epi32(with, old);
+            __m256i split = _mm256_blendv_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(prevSplit + k)),
+                                               _mm256_loadu_si256(reinterpret_cast<const __m256i*>(shiftedSplit + k)), take);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(nextSplit + k), split);
+        }
+    }
+    maxAddScalar(prev + k, shifted + k, next + k, prevSplit ? prevSplit + k : nullptr,
+                 shiftedSplit ? shiftedSplit + k : nullptr, nextSplit ? nextSplit + k : nullptr, count - k, value);
+}
+
+// maxAddScalar() sixteen cells at a time (AVX-512)
+__attribute__((target("avx512f")))
+void maxAddAvx512(const int* prev, const int* shifted, int* next, const int* prevSplit, const int* shiftedSplit,
+                  int* nextSplit, int count, int value) {
+    const __m512i add = _mm512_set1_epi32(value);
+    int k = 0;
+    for (; k + 16 <= count; k += 16) {
+        __m512i old = _mm512_loadu_si512(prev + k);
+        __m512i with = _mm512_add_epi32(_mm512_loadu_si512(shifted + k), add);
+        __mmask16 take = _mm512_cmpgt_epi32_mask(with, old);
+        _mm512_storeu_si512(next + k, _mm512_mask_blend_epi32(take, old, with));
+        if (nextSplit) {
+            _mm512_storeu_si512(nextSplit + k, _mm512_mask_blend_epi32(take, _mm512_loadu_si512(prevSplit + k),
+                                                                       _mm512_loadu_si512(shiftedSplit + k)));
+        }
+    }
+    maxAddScalar(prev + k, shifted + k, next + k, prevSplit ? prevSplit + k : nullptr,
+                 shiftedSplit ? shiftedSplit + k : nullptr, nextSplit ? nextSplit + k : nullptr, count - k, value);
+}
+#endif
+
+// Function to compute capacities [lo, hi) of a DP row from the previous row, as the 2-D
+// fill does: below the item's weight (and at w = 0 unless zeroColumn) the row is copied,
+// the rest is one contiguous max-add slice. Split rows are optional (nullptr).
+void updateRow(Isa isa, const Item& item, const int* prev, int* next, const int* prevSplit, int* nextSplit,
+               int lo, int hi, bool zeroColumn) {
+    int start = min(hi, max(lo, max(item.weight, zeroColumn ? 0 : 1)));
+    copy(prev + lo, prev + start, next + lo);
+    if (nextSplit) copy(prevSplit + lo, prevSplit + start, nextSplit + lo);
+    if (start == hi) return;
+    const int* shifted = prev + start - item.weight;
+    const int* shiftedSplit = nextSplit ? prevSplit + start - item.weight : nullptr;
+    int count = hi - start;
+#if defined(__x86_64__) || defined(__i386__)
+    if (isa == Isa::Avx512) {
+        maxAddAvx512(prev + start, shifted, next + start, nextSplit ? prevSplit + start : nullptr, shiftedSplit,
+                     nextSplit ? nextSplit + start : nullptr, count, item.value);
+        return;
+    }
+    if (isa == Isa::Avx2) {
+        maxAddAvx2(prev + start, shifted, next + start, nextSplit ? prevSplit + start : nullptr, shiftedSplit,
+                   nextSplit ? nextSplit + start : nullptr, count, item.value);
+        return;
+    }
+#endif
+    maxAddScalar(prev + start, shifted, next + start, nextSplit ? prevSplit + start : nullptr, shiftedSplit,
+                 nextSplit ? nextSplit + start : nullptr, count, item.value);
+}
+
+// Barrier for the threads updating one DP row, so no thread starts the next row before
+// the whole previous row is written
+class RowBarrier {
+public:
+    explicit RowBarrier(int count) : count(count) {}
+
+    void wait() {
+        unique_lock<mutex> lock(m);
+        size_t seen = generation;
+        if (++waiting == count) {
+            waiting = 0;
+            generation++;
+            released.notify_all();
+        } else {
+            released.wait(lock, [&] { return generation != seen; });
+        }
+    }
+
+private:
+    mutex m;
+    condition_variable released;
+    int count, waiting = 0;
+    size_t generation = 0;
+};
+
+// Rolling DP rows: the current row and the one being written, with optional split rows
+// (see knapsackRolling()), each W + 1 entries
+struct DpRows {
+    vector<int> value, nextValue, split, nextSplit;
+};
+
+// Function to add items[first .. last - 1] to the rolling rows at capacity W
+// Every thread owns a contiguous range of capacities and all threads meet at a barrier
+// after each item; the result ends up in rows.value (and rows.split if withSplit).
+void addItems(const vector<Item>& items, int first, int last, int W, bool zeroColumn, DpRows& rows, bool withSplit,
+              const DpKernel& kernel) {
+    int threads = max(1, min(kernel.threads, (W + 1) / MIN_CELLS_PER_THREAD));
+    RowBarrier barrier(threads);
+    auto work = [&](int t) {
+        int lo = (long long)(W + 1) * t / threads, hi = (long long)(W + 1) * (t + 1) / threads;
+        int *prev = rows.value.data(), *next = rows.nextValue.data();
+        int *prevSplit = withSplit ? rows.split.data() : nullptr, *nextSplit = withSplit ? rows.nextSplit.data() : nullptr;
+        for (int i = first; i < last; ++i) {
+            updateRow(kernel.isa, items[i], prev, next, prevSplit, nextSplit, lo, hi, zeroColumn);
+            swap(prev, next);
+            swap(prevSplit, nextSplit);
+            if (threads > 1) barrier.wait();
+        }
+    };
+    vector<thread> workers;
+    for (int t = 1; t < threads; ++t) workers.emplace_back(work, t);
+    work(0);
+    for (auto& w : workers) w.join();
+    if ((last - first) % 2 == 1) {
+        swap(rows.value, rows.nextValue);
+        if (withSplit) swap(rows.split, rows.nextSplit);
+    }
+}
+
+// Function to fill the full 2-D table and backtrack the chosen items
 // Parameters:
-// - W: Maximum weight capacity of the truck
-// - items: Vector of available items
-void solveKnapsack(int W, const vector<Item>& items) {
-    int n = items.size();  // Number of items
+// - W: Weight capacity
+// - items: The items
+// - first, last: Only items[first .. last - 1] are considered
+// - chosen: Receives the chosen item indices, highest first
+// - kernel: Row update (the table is filled by one thread)
+// - zeroColumn: Fill column w = 0 as well (the original fill starts at w = 1, so items
+//   of weight 0 are never taken once no capacity is left)
+// Returns the maximum value.
+int knapsackTable(int W, const vector<Item>& items, int first, int last, vector<int>& chosen, KnapsackStats& stats,
+                  const DpKernel& kernel, bool zeroColumn = false) {
+    int n = last - first;  // Number of items
 
     // DP table: dp[i][w] = maximum value using first i items with weight limit w
     vector<vector<int>> dp(n + 1, vector<int>(W + 1, 0));
+    stats.cells += (long long)n * W;
+    stats.peakBytes = max(stats.peakBytes, size_t(n + 1) * (W + 1) * sizeof(int));
 
-    // Fill the DP table
+    // Fill the DP table: dp[i][w] = max(dp[i - 1][w], value + dp[i - 1][w - weight])
+    // where the item fits, dp[i - 1][w] elsewhere
     for (int i = 1; i <= n; ++i) {
-        for (int w = 1; w <= W; ++w) {
-            // If the current item's weight is less than or equal to current capacity
-            if (items[i - 1].weight <= w) {
-                // Choose max of: including the item or not including it
-                dp[i][w] = max(items[i - 1].value + dp[i - 1][w - items[i - 1].weight],
-                               dp[i - 1][w]);
-            } else {
-                // Cannot include the item, take the value without it
-                dp[i][w] = dp[i - 1][w];
-            }
-        }
+        updateRow(kernel.isa, items[first + i - 1], dp[i - 1].data(), dp[i].data(), nullptr, nullptr, 0, W + 1,
+                  zeroColumn);
     }
 
-    // Output the optimal solution
-    cout << "\nOptimal Solution:\n";
-    cout << "Maximum Utility Value: " << dp[n][W] << endl;
-    cout << "Items to include in the truck:\n";
-
     // Backtrack to find which items were included
     int maxValue = dp[n][W];  // Current maximum value
     int w = W;                // Current weight capacity
     for (int i = n; i > 0 && maxValue > 0; --i) {
         // If the value changed, this item was included
         if (maxValue != dp[i - 1][w]) {
-            // This item was included
-            cout << "- " << items[i - 1].name << " (Value: "
-                 << items[i - 1].value << ", Weight: "
-                 << items[i - 1].weight << ")" << endl;
-
+            chosen.push_back(first + i - 1);
             // Update remaining value and weight
-            maxValue -= items[i - 1].value;
-            w -= items[i - 1].weight;
+            maxValue -= items[first + i - 1].value;
+            w -= items[first + i - 1].weight;
         }
     }
+    return dp[n][W];
+}
+
+// Function to recover the chosen items of items[first .. last - 1] at capacity W with
+// rolling rows (shared by the whole recursion)
+// The backtrack of the 2-D table always drops the highest item it can, so it picks the
+// same items as the backtrack of any block of items run on its own, at the capacity
+// the block ends up with. One forward pass finds the capacity the backtrack has when
+// it crosses the middle item; the two halves are then solved the same way.
+// Column 0 of a block only behaves like the original's (no weightless items) when it is
+// capacity 0 of the whole problem; zeroColumn is false exactly then.
+// Returns the maximum value.
+int knapsackRolling(int W, const vector<Item>& items, int first, int last, DpRows& rows, vector<int>& chosen,
+                    KnapsackStats& stats, const DpKernel& kernel, bool zeroColumn) {
+    if (W < 0 || (W == 0 && !zeroColumn) || first == last) return 0;
+    if (last - first == 1 || (long long)(last - first) * (W + 1) <= HIRSCHBERG_BASE_CELLS) {
+        KnapsackStats base;
+        int best = knapsackTable(W, items, first, last, chosen, base, kernel, zeroColumn);
+        stats.cells += base.cells;
+        stats.peakBytes = max(stats.peakBytes, 4 * rows.value.size() * sizeof(int) + base.peakBytes);
+        return best;
+    }
+
+    int mid = first + (last - first) / 2;
+    fill(rows.value.begin(), rows.value.begin() + W + 1, 0);
+    addItems(items, first, mid, W, zeroColumn, rows, false, kernel);
+    for (int w = 0; w <= W; ++w) rows.split[w] = w;
+    addItems(items, mid, last, W, zeroColumn, rows, true, kernel);
+    stats.cells += (long long)(last - first) * W;
+    int best = rows.value[W], lowerCapacity = rows.split[W];
+
+    // Upper half first, so the items come out highest first as in the 2-D backtrack
+    knapsackRolling(W - lowerCapacity, items, mid, last, rows, chosen, stats, kernel, zeroColumn || lowerCapacity > 0);
+    knapsackRolling(lowerCapacity, items, first, mid, rows, chosen, stats, kernel, zeroColumn);
+    return best;
+}
+
+// Function to solve with knapsackRolling() in O(W) memory
+int knapsackRolling(int W, const vector<Item>& items, vector<int>& chosen, KnapsackStats& stats, const DpKernel& kernel) {
+    size_t size = max(W, 0) + 1;
+    DpRows rows{vector<int>(size), vector<int>(size), vector<int>(size), vector<int>(size)};
+    stats.peakBytes = 4 * size * sizeof(int);
+    return knapsackRolling(W, items, 0, items.size(), rows, chosen, stats, kernel, false);
+}
+
+// Function to solve the 0/1 knapsack problem using dynamic programming
+// Parameters:
+// - W: Maximum weight capacity of the truck
+// - items: Vector of available items
+// - rolling: Use the O(W)-memory rolling DP instead of the full table
+// - kernel: Row update
+void solveKnapsack(int W, const vector<Item>& items, bool rolling, const DpKernel& kernel) {
+    vector<int> chosen;
+    KnapsackStats stats;
+    int maxValue = rolling ? knapsackRolling(W, items, chosen, stats, kernel)
+                           : knapsackTable(W, items, 0, items.size(), chosen, stats, kernel);
+
+    // Output the optimal solution
+    cout << "\nOptimal Solution:\n";
+    cout << "Maximum Utility Value: " << maxValue << endl;
+    cout << "Items to include in the truck:\n";
+    for (int i : chosen) {
+        cout << "- " << items[i].name << " (Value: "
+             << items[i].value << ", Weight: "
+             << items[i].weight << ")" << endl;
+    }
     cout << "----------------------------------------\n";
 }
 
+// Item types left for the DP after preprocessing a manifest: one kind per distinct
+// (weight, value), with the number of copies that may still be worth loading
+struct Manifest {
+    vector<Item> kinds;            // Weight and value of each kind (named after its first type)
+    vector<long long> copies;      // Copies of each kind left
+    vector<vector<int>> types;     // Input item types merged into each kind, in input order
+};
+
+// What preprocessing removed
+struct PruneStats {
+    int types = 0;             // Input item types
+    int unusable = 0;          // Types that can never be loaded (too heavy, no value, no copies)
+    int merged = 0;            // Types merged into another with the same weight and value
+    int dominated = 0;         // Kinds dropped because lighter, more valuable kinds fill the truck
+    long long unitsBefore = 0; // Copies in the manifest
+    long long unitsAfter = 0;  // Copies left for the DP
+};
+
+// Function to preprocess a manifest of item types with quantities
+// Types with the same weight and value are merged, and no kind keeps more copies than
+// fit the truck. A kind A is dominated by every other kind B that is no heavier and at
+// least as valuable: swapping a loaded A for an unused B never hurts, so some optimal
+// load only takes A once all of its dominators are loaded, and A keeps just the copies
+// that still fit next to them (often none).
+// Parameters:
+// - W: Weight capacity
+// - items: Item types
+// - quantity: Copies of each type
+// - stats: Receives what was removed
+Manifest pruneManifest(int W, const vector<Item>& items, const vector<long long>& quantity, PruneStats& stats) {
+    Manifest m;
+    stats.types = items.size();
+    vector<int> order;
+    for (int i = 0; i < int(items.size()); ++i) {
+        stats.unitsBefore += quantity[i];
+        if (items[i].weight >= 0 && items[i].weight <= W && items[i].value > 0 && quantity[i] > 0) {
+            order.push_back(i);
+        } else {
+            stats.unusable++;
+        }
+    }
+
+    // Lightest first, most valuable first among equal weights: every dominator of a
+    // kind comes before it
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        if (items[a].weight != items[b].weight) return items[a].weight < items[b].weight;
+        return items[a].value > items[b].value;
+    });
+    for (int i : order) {
+        if (!m.kinds.empty() && m.kinds.back().weight == items[i].weight && m.kinds.back().value == items[i].value) {
+            m.copies.back() += quantity[i];
+            m.types.back().push_back(i);
+            stats.merged++;
+        } else {
+            m.kinds.push_back(items[i]);
+            m.copies.push_back(quantity[i]);
+            m.types.push_back({i});
+        }
+    }
+
+    // Weight of the copies already kept, indexed by value rank (most valuable first) in a
+    // Fenwick tree, so the dominators of a kind are a prefix
+    vector<int> values;
+    for (const Item& kind : m.kinds) values.push_back(kind.value);
+    sort(values.begin(), values.end(), greater<int>());
+    values.erase(unique(values.begin(), values.end()), values.end());
+    vector<long long> keptWeight(values.size() + 1, 0);
+
+    Manifest kept;
+    for (size_t k = 0; k < m.kinds.size(); ++k) {
+        const Item& kind = m.kinds[k];
+        int rank = lower_bound(values.begin(), values.end(), kind.value, greater<int>()) - values.begin() + 1;
+        long long copies = m.copies[k];
+        if (kind.weight > 0) {
+            long long dominators = 0;
+            for (int r = rank; r > 0; r -= r & -r) dominators += keptWeight[r];
+            copies = dominators > W ? 0 : min(copies, (W - dominators) / kind.weight);
+        }
+        if (copies == 0) {
+            stats.dominated++;
+            continue;
+        }
+        for (int r = rank; r < int(keptWeight.size()); r += r & -r) keptWeight[r] += copies * kind.weight;
+        kept.kinds.push_back(kind);
+        kept.copies.push_back(copies);
+        kept.types.push_back(m.types[k]);
+        stats.unitsAfter += copies;
+    }
+    return kept;
+}
+
+// Function to split every kind into 0/1 pieces of 1, 2, 4, ... copies and a remainder, so
+// any number of copies up to the limit is a set of pieces (binary splitting)
+// Piece values must fit an int (knapsackBounded() checks its bound); a piece heavier
+// than INT_MAX is stored as INT_MAX, which no truck fits.
+// Parameters:
+// - m: Preprocessed manifest
+// - pieceKind, pieceCopies: Receive the kind and number of copies of each piece
+vector<Item> splitPieces(const Manifest& m, vector<int>& pieceKind, vector<long long>& pieceCopies) {
+    vector<Item> pieces;
+    for (size_t k = 0; k < m.kinds.size(); ++k) {
+        long long left = m.copies[k];
+        for (long long size = 1; left > 0; size *= 2) {
+            long long take = min(size, left);
+            int weight = m.kinds[k].weight;
+            pieces.push_back({m.kinds[k].name, int(m.kinds[k].value * take),
+                              weight > 0 && take > INT_MAX / weight ? INT_MAX : int(weight * take)});
+            pieceKind.push_back(k);
+            pieceCopies.push_back(take);
+            left -= take;
+        }
+    }
+    return pieces;
+}
+
+// Function to solve the bounded knapsack (item types with quantities): preprocess, split
+// into 0/1 pieces and solve those with the 0/1 DP
+// Values are added up in 64 bits. If every valuable copy fits the truck they are all
+// loaded without a DP; otherwise the DP's int cells must hold the most a load can be
+// worth: neither more than all copies that fit nor more than W times the best value per
+// unit of weight. Manifests where both bounds pass INT_MAX are refused.
+// Parameters:
+// - W: Maximum weight capacity of the truck
+// - items: Item types
+// - quantity: Copies of each type
+// - loaded: Receives the copies of each type to load
+// - stats: Receives what preprocessing removed
+// - pieces: Receives the number of 0/1 items the DP ran on
+// - rolling, kernel: As for solveKnapsack()
+// - prune: Preprocess (false splits every type as given)
+// Returns the maximum value, or -1 if the values are too large for the DP.
+long long knapsackBounded(int W, const vector<Item>& items, const vector<long long>& quantity, vector<long long>& loaded,
+                    PruneStats& stats, size_t& pieces, bool rolling, const DpKernel& kernel, bool prune = true) {
+    Manifest m;
+    if (prune) {
+        m = pruneManifest(W, items, quantity, stats);
+    } else {
+        for (int i = 0; i < int(items.size()); ++i) {
+            m.kinds.push_back(items[i]);
+            m.copies.push_back(quantity[i]);
+            m.types.push_back({i});
+        }
+    }
+    // Weightless kinds are always loaded in full; the rest goes through the DP
+    Manifest weighted;
+    vector<long long> kindCopies;
+    long long best = 0, dpTotal = 0, ratioBound = 0, weightTotal = 0;
+    bool allFit = true;
+    for (size_t k = 0; k < m.kinds.size(); ++k) {
+        const Item& kind = m.kinds[k];
+        bool free = kind.weight == 0 && kind.value > 0;
+        kindCopies.push_back(free ? m.copies[k] : 0);
+        if (free) best += kind.value * m.copies[k];
+        weighted.kinds.push_back(kind);
+        weighted.copies.push_back(free ? 0 : m.copies[k]);
+        if (free || kind.value <= 0) continue;
+        // Copies past what fits the truck are never loaded (pruning already drops them)
+        long long copies = kind.weight > 0 ? min<long long>(m.copies[k], W / kind.weight) : m.copies[k];
+        weighted.copies.back() = copies;
+        // Value of all copies (capped once past the DP's limit), W at this value per
+        // weight, and whether they fit
+        dpTotal = copies > INT_MAX ? LLONG_MAX : min<long long>(LLONG_MAX / 2, dpTotal + kind.value * copies);
+        ratioBound = kind.weight > 0 ? max(ratioBound, (long long)W * kind.value / kind.weight) : LLONG_MAX;
+        allFit = allFit && kind.weight > 0 && m.copies[k] <= (W - weightTotal) / kind.weight;
+        if (allFit) weightTotal += kind.weight * m.copies[k];
+    }
+    pieces = 0;
+    loaded.assign(items.size(), 0);
+    if (allFit) {
+        // Every valuable copy fits: load them all
+        for (size_t k = 0; k < m.kinds.size(); ++k) {
+            if (m.kinds[k].weight > 0 && m.kinds[k].value > 0) {
+                kindCopies[k] = m.copies[k];
+                best += m.kinds[k].value * m.copies[k];
+            }
+        }
+    } else {
+        if (min(dpTotal, ratioBound) > INT_MAX) return -1;
+        vector<int> pieceKind;
+        vector<long long> pieceCopies;
+        vector<Item> split = splitPieces(weighted, pieceKind, pieceCopies);
+        pieces = split.size();
+
+        vector<int> chosen;
+        KnapsackStats dpStats;
+        best += rolling ? knapsackRolling(W, split, chosen, dpStats, kernel)
+                        : knapsackTable(W, split, 0, split.size(), chosen, dpStats, kernel);
+        for (int p : chosen) kindCopies[pieceKind[p]] += pieceCopies[p];
+    }
+
+    // Hand the chosen copies of each kind back to its types in input order
+    for (size_t k = 0; k < m.kinds.size(); ++k) {
+        for (int i : m.types[k]) {
+            loaded[i] = min(quantity[i], kindCopies[k]);
+            kindCopies[k] -= loaded[i];
+        }
+    }
+    return best;
+}
+
+// Function to solve the truck loading with quantities and display the results
+// Parameters:
+// - W: Maximum weight capacity of the truck
+// - items: Item types
+// - quantity: Copies of each type
+// - rolling, kernel: As for solveKnapsack()
+void solveBoundedKnapsack(int W, const vector<Item>& items, const vector<long long>& quantity, bool rolling,
+                          const DpKernel& kernel) {
+    vector<long long> loaded;
+    PruneStats stats;
+    size_t pieces;
+    long long maxValue = knapsackBounded(W, items, quantity, loaded, stats, pieces, rolling, kernel);
+    if (maxValue < 0) {
+        cout << "Error: The best load may be worth more than " << INT_MAX << ", too much for the DP." << endl;
+        return;
+    }
+
+    // Report what preprocessing saved: DP rows against one row per copy
+    double rowsSaved = stats.unitsBefore ? 100.0 * (1 - double(pieces) / stats.unitsBefore) : 0.0;
+    cout << "\nPreprocessing: " << stats.types << " item types, " << stats.unusable << " unusable, " << stats.merged
+         << " merged, " << stats.dominated << " dominated; " << stats.unitsBefore << " copies -> " << stats.unitsAfter
+         << " -> " << pieces << " DP items (" << fixed << setprecision(1) << rowsSaved << "% of the DP work saved)\n"
+         << defaultfloat;
+
+    // Output the optimal solution
+    cout << "\nOptimal Solution:\n";
+    cout << "Maximum Utility Value: " << maxValue << endl;
+    cout << "Items to include in the truck:\n";
+    for (int i = items.size() - 1; i >= 0; --i) {
+        if (loaded[i] == 0) continue;
+        cout << "- " << items[i].name << " x" << loaded[i] << " (Value: "
+             << items[i].value << ", Weight: "
+             << items[i].weight << ")" << endl;
+    }
+    cout << "----------------------------------------\n";
+}
+
+// Function to generate random items (values 1..1000, weights 1..W/10)
+vector<Item> randomItems(int n, int W) {
+    mt19937 rng(23);
+    vector<Item> items(n);
+    for (int i = 0; i < n; ++i) {
+        items[i] = {"item" + to_string(i), 1 + int(rng() % 1000), 1 + int(rng() % max(1, W / 10))};
+    }
+    return items;
+}
+
+// Function to compare the rolling DP with the full table on random items
+// Parameters:
+// - n: Number of items
+// - W: Capacity
+// - kernel: Row update
+// Returns false if the two pick different items.
+bool benchmarkKnapsack(int n, int W, const DpKernel& kernel) {
+    vector<Item> items = randomItems(n, W);
+    auto run = [&](bool rolling, vector<int>& chosen, KnapsackStats& stats) {
+        auto begin = chrono::steady_clock::now();
+        int best = rolling ? knapsackRolling(W, items, chosen, stats, kernel)
+                           : knapsackTable(W, items, 0, n, chosen, stats, kernel);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        cout << setw(10) << (rolling ? "rolling" : "2-D table") << setw(14) << best << setw(10) << chosen.size()
+             << fixed << setprecision(3) << setw(12) << seconds << setw(14) << setprecision(1)
+             << stats.peakBytes / 1048576.0 << setw(16) << setprecision(2) << stats.cells / seconds / 1e9 << "\n"
+             << defaultfloat;
+    };
+
+    cout << "0/1 knapsack: " << n << " items, capacity " << W << ", " << isaName(kernel.isa) << ", " << kernel.threads
+         << " threads\n";
+    cout << setw(10) << "mode" << setw(14) << "value" << setw(10) << "items" << setw(12) << "seconds" << setw(14)
+         << "peak MB" << setw(16) << "Gcells/s" << "\n";
+    vector<int> rollingChosen, tableChosen;
+    KnapsackStats rollingStats, tableStats;
+    run(true, rollingChosen, rollingStats);
+
+    double tableBytes = double(n + 1) * (W + 1) * sizeof(int);
+    if (tableBytes > double(size_t(2) << 30)) {
+        cout << setw(10) << "2-D table" << "  skipped: needs " << fixed << setprecision(1) << tableBytes / 1073741824.0
+             << " GB\n" << defaultfloat;
+        return true;
+    }
+    run(false, tableChosen, tableStats);
+    bool same = rollingChosen == tableChosen;
+    cout << "Chosen items " << (same ? "identical" : "DIFFER") << "\n";
+    return same;
+}
+
+// Function to time the DP fill (all items into one rolling row) for every instruction set
+// this CPU supports and 1, 2, 4, ... threads, checking that every row is identical
+// Parameters:
+// - n: Number of items
+// - W: Capacity
+// - maxThreads: Largest thread count
+// Returns false if any row differs from the scalar one-thread row.
+bool benchmarkKernel(int n, int W, int maxThreads) {
+    vector<Item> items = randomItems(n, W);
+    size_t size = W + 1;
+    vector<int> expected;
+    bool ok = true;
+    cout << "DP row kernel: " << n << " items, capacity " << W << "\n";
+    cout << setw(8) << "isa" << setw(9) << "threads" << setw(12) << "seconds" << setw(12) << "Gcells/s" << "\n";
+    for (Isa isa : {Isa::Scalar, Isa::Avx2, Isa::Avx512}) {
+        if (!isaSupported(isa)) {
+            cout << setw(8) << isaName(isa) << "  not supported by this CPU\n";
+            continue;
+        }
+        for (int threads = 1; threads <= maxThreads; threads = threads < maxThreads ? min(2 * threads, maxThreads) : threads + 1) {
+            DpRows rows{vector<int>(size, 0), vector<int>(size), {}, {}};
+            auto begin = chrono::steady_clock::now();
+            addItems(items, 0, n, W, false, rows, false, DpKernel{isa, threads});
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            bool same = expected.empty() || rows.value == expected;
+            if (expected.empty()) expected = rows.value;
+            if (!same) ok = false;
+            cout << setw(8) << isaName(isa) << setw(9) << threads << fixed << setprecision(3) << setw(12) << seconds
+                 << setw(12) << setprecision(2) << double(n) * W / seconds / 1e9 << (same ? "" : "  DIFFERS") << "\n"
+                 << defaultfloat;
+        }
+    }
+    return ok;
+}
+
+// Function to compare bounded-knapsack strategies on a random manifest: every copy as a
+// 0/1 item, binary splitting alone, and preprocessing plus binary splitting
+// Parameters:
+// - types: Number of item types (about a third share a weight and value with another)
+// - W: Capacity
+// - kernel: Row update
+// Returns false if the strategies disagree on the maximum value or load too much.
+bool benchmarkBounded(int types, int W, const DpKernel& kernel) {
+    mt19937 rng(25);
+    vector<Item> items(types);
+    vector<long long> quantity(types);
+    for (int i = 0; i < types; ++i) {
+        if (i > 0 && rng() % 3 == 0) {
+            items[i] = items[rng() % i];
+        } else {
+            items[i] = {"", 1 + int(rng() % 1000), 1 + int(rng() % max(1, W / 20))};
+        }
+        items[i].name = "sku" + to_string(i);
+        quantity[i] = 1 + rng() % 1000;
+    }
+    long long units = 0;
+    for (long long q : quantity) units += q;
+
+    cout << "Bounded knapsack: " << types << " item types, " << units << " copies, capacity " << W << "\n";
+    cout << setw(24) << "strategy" << setw(14) << "value" << setw(12) << "DP items" << setw(16) << "DP cells" << setw(12)
+         << "seconds" << "\n";
+    bool ok = true;
+    long long expected = -1;
+    auto report = [&](const string& name, long long best, size_t dpItems, double seconds, const vector<long long>& loaded) {
+        long long weight = 0, value = 0;
+        for (int i = 0; i < types; ++i) {
+            weight += loaded[i] * items[i].weight;
+            value += loaded[i] * items[i].value;
+            if (loaded[i] > quantity[i]) ok = false;
+        }
+        if (weight > W || value != best || (expected >= 0 && best != expected)) ok = false;
+        if (expected < 0) expected = best;
+        cout << setw(24) << name << setw(14) << best << setw(12) << dpItems << setw(16) << double(dpItems) * W
+             << fixed << setprecision(3) << setw(12) << seconds << "\n" << defaultfloat;
+    };
+    auto seconds = [](chrono::steady_clock::time_point a) {
+        return chrono::duration<double>(chrono::steady_clock::now() - a).count();
+    };
+
+    // Every copy as its own 0/1 item, while that stays affordable
+    if (double(units) * W <= 2e10) {
+        vector<Item> expanded;
+        vector<int> typeOf;
+        for (int i = 0; i < types; ++i) {
+            for (long long c = 0; c < quantity[i]; ++c) {
+                expanded.push_back(items[i]);
+                typeOf.push_back(i);
+            }
+        }
+        vector<int> chosen;
+        KnapsackStats dpStats;
+        auto begin = chrono::steady_clock::now();
+        int best = knapsackRolling(W, expanded, chosen, dpStats, kernel);
+        double elapsed = seconds(begin);
+        vector<long long> loaded(types, 0);
+        for (int p : chosen) loaded[typeOf[p]]++;
+        report("every copy (0/1)", best, expanded.size(), elapsed, loaded);
+    } else {
+        cout << setw(24) << "every copy (0/1)" << "  skipped: " << double(units) * W << " DP cells\n";
+    }
+
+    for (bool prune : {false, true}) {
+        vector<long long> loaded;
+        PruneStats stats;
+        size_t pieces;
+        auto begin = chrono::steady_clock::now();
+        long long best = knapsackBounded(W, items, quantity, loaded, stats, pieces, true, kernel, prune);
+        double elapsed = seconds(begin);
+        report(prune ? "preprocess + splitting" : "binary splitting", best, pieces, elapsed, loaded);
+        if (prune) {
+            cout << "Preprocessing removed " << stats.unusable << " unusable, " << stats.merged << " merged and "
+                 << stats.dominated << " dominated types; " << stats.unitsBefore << " copies -> " << stats.unitsAfter
+                 << "\n";
+        }
+    }
+    cout << "Maximum values " << (ok ? "agree and loads are valid" : "DIFFER or a load is invalid") << "\n";
+    return ok;
+}
+
 // Main function: Entry point of the program
-int main() {
+int main(int argc, char* argv[]) {
+    // Command-line options: DP mode, kernel and input format, or benchmark mode
+    bool rolling = false, quantities = false;
+    DpKernel kernel{Isa::Scalar, max(1, int(thread::hardware_concurrency()))};
+    for (Isa isa : {Isa::Avx2, Isa::Avx512}) {
+        if (isaSupported(isa)) kernel.isa = isa;
+    }
+    string bench;
+    int benchItems = 0, benchCapacity = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--rolling") {
+            rolling = true;
+        } else if (arg == "--quantities") {
+            quantities = true;
+        } else if (arg == "--isa=scalar" || arg == "--isa=avx2" || arg == "--isa=avx512") {
+            Isa isa = arg == "--isa=avx512" ? Isa::Avx512 : arg == "--isa=avx2" ? Isa::Avx2 : Isa::Scalar;
+            if (!isaSupported(isa)) {
+                cout << "Error: This CPU does not support " << isaName(isa) << "." << endl;
+                return 1;
+            }
+            kernel.isa = isa;
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            kernel.threads = max(1, stoi(arg.substr(10)));
+        } else if (arg.rfind("--bench=", 0) == 0 || arg.rfind("--kernel-bench=", 0) == 0 ||
+                   arg.rfind("--bounded-bench=", 0) == 0) {
+            size_t equals = arg.find('='), comma = arg.find(',');
+            bench = arg.substr(2, equals - 2);
+            benchItems = stoi(arg.substr(equals + 1));
+            if (comma != string::npos) benchCapacity = stoi(arg.substr(comma + 1));
+        } else {
+            cout << "Usage: " << argv[0] << " [--rolling] [--quantities] [--isa=scalar|avx2|avx512] [--threads=N] [--bench=N[,W]] [--kernel-bench=N[,W]] [--bounded-bench=T[,W]]" << endl;
+            return 1;
+        }
+    }
+    if (bench == "bench") return benchmarkKnapsack(benchItems, benchCapacity, kernel) ? 0 : 1;
+    if (bench == "kernel-bench") return benchmarkKernel(benchItems, benchCapacity, kernel.threads) ? 0 : 1;
+    if (bench == "bounded-bench") return benchmarkBounded(benchItems, benchCapacity, kernel) ? 0 : 1;
+
     // Variable for truck's weight capacity
     int truckCapacity;
     cout << "Enter the truck's maximum weight capacity: ";
@@ -83,16 +789,22 @@ int main() {
     cout << "Enter the number of available item types: ";
     cin >> n;
 
-    // Vector to store the items
+    // Vector to store the items (and with --quantities, the copies of each)
     vector<Item> availableItems(n);
-    cout << "Enter the details for each item (name value weight):" << endl;
+    vector<long long> quantity(n, 1);
+    cout << "Enter the details for each item (name value weight" << (quantities ? " quantity" : "") << "):" << endl;
     for (int i = 0; i < n; ++i) {
         // Read item details from input
         cin >> availableItems[i].name >> availableItems[i].value >>
                availableItems[i].weight;
+        if (quantities) cin >> quantity[i];
     }
 
     // Solve the knapsack problem and display results
-    solveKnapsack(truckCapacity, availableItems);
+    if (quantities) {
+        solveBoundedKnapsack(truckCapacity, availableItems, quantity, rolling, kernel);
+    } else {
+        solveKnapsack(truckCapacity, availableItems, rolling, kernel);
+    }
     return 0;  // Successful execution
 }